@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "parallel_noise.h"
+#include "protegon/protegon.h"
+
+using namespace ptgn;
+
+// Sweeps level grid sizes and thread counts for the banded fractal noise generation used by
+// the tornado map and checks that it matches FractalNoise::Generate bit for bit.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int repeats{ 5 };
+
+template <typename F>
+double TimeMilliseconds(F&& function) {
+	auto start{ Clock::now() };
+	for (int i{ 0 }; i < repeats; i++) {
+		function();
+	}
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+}
+
+int main() {
+	// Same properties as the grass noise map in GameScene::Init, which is the more expensive
+	// of the two maps.
+	NoiseProperties properties;
+	properties.octaves	   = 6;
+	properties.frequency   = 0.57f;
+	properties.bias		   = 4.4f;
+	properties.persistence = 1.7f;
+
+	ValueNoise noise{ 256, 0 };
+
+	// One screen of the game is 90x50 tiles.
+	const V2_int screen_tiles{ 90, 50 };
+	const std::vector<V2_int> screen_sizes{ { 1, 1 }, { 1, 5 }, { 4, 4 }, { 10, 10 } };
+
+	std::vector<std::size_t> thread_counts{ 1, 2, 4, 8 };
+	std::size_t hardware_threads{ std::thread::hardware_concurrency() };
+	if (hardware_threads > thread_counts.back()) {
+		thread_counts.push_back(hardware_threads);
+	}
+
+	std::cout << "grid, threads, ms, speedup, identical\n";
+
+	bool all_identical{ true };
+
+	for (const V2_int& screen_size : screen_sizes) {
+		V2_int grid_size{ screen_size * screen_tiles };
+
+		std::vector<float> reference;
+		double reference_ms{ TimeMilliseconds([&]() {
+			reference = FractalNoise::Generate(noise, {}, grid_size, properties);
+		}) };
+
+		for (std::size_t thread_count : thread_counts) {
+			std::vector<float> result;
+			double ms{ TimeMilliseconds([&]() {
+				result = GenerateFractalNoise(noise, grid_size, properties, thread_count);
+			}) };
+			bool identical{ result == reference };
+			all_identical &= identical;
+			std::cout << grid_size.x << "x" << grid_size.y << ", " << thread_count << ", " << ms
+					  << ", " << reference_ms / ms << ", " << (identical ? "yes" : "NO") << "\n";
+		}
+	}
+
+	return all_identical ? 0 : 1;
+}
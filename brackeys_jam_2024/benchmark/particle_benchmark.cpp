@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "debris_particles.h"
+#include "protegon/protegon.h"
+
+using namespace ptgn;
+
+// Compares the previous per tornado ecs::Manager particle update with the structure-of-arrays
+// DebrisParticles kernel used by TornadoComponent.
+
+constexpr float dt{ 1.0f / 60.0f };
+constexpr int frames{ 200 };
+
+constexpr float escape_radius{ 64.0f };
+constexpr float gravity_radius{ 512.0f };
+constexpr float turn_speed{ 50.0f };
+constexpr float wind_constant{ 3.0f };
+constexpr float particle_max_thrust{ 200.0f };
+constexpr float particle_pull_resistance{ 0.1f };
+constexpr float particle_drag_force{ 0.01f };
+
+const V2_float tornado_pos{ 1000.0f, 1000.0f };
+
+using Clock = std::chrono::steady_clock;
+
+double BenchmarkEcs(std::size_t particle_count) {
+	ecs::Manager manager;
+	manager.Reserve(particle_count);
+
+	std::vector<ecs::Entity> available_entities;
+	available_entities.reserve(particle_count);
+
+	RNG<float> rng_pos{ -gravity_radius * 0.5f, gravity_radius * 0.5f };
+
+	for (std::size_t i{ 0 }; i < particle_count; i++) {
+		auto particle{ manager.CreateEntity() };
+		particle.Add<Transform>().position = tornado_pos + V2_float{ rng_pos(), rng_pos() };
+		particle.Add<RigidBody>();
+	}
+	manager.Refresh();
+
+	Circle inner_deletion_circle{ tornado_pos, escape_radius * 0.1f };
+	Circle outer_deletion_circle{ tornado_pos, gravity_radius };
+
+	auto start{ Clock::now() };
+
+	for (int frame{ 0 }; frame < frames; frame++) {
+		for (auto [e, transform, rigid_body] : manager.EntitiesWith<Transform, RigidBody>()) {
+			V2_float dir{ tornado_pos - transform.position };
+
+			float dist2{ dir.MagnitudeSquared() };
+			V2_float suction{ dir / dist2 * escape_radius * particle_max_thrust };
+			float dist2_wind{ dir.MagnitudeSquared() };
+			V2_float wind{ dir.Skewed() / dist2_wind * escape_radius * wind_constant *
+						   turn_speed / particle_pull_resistance };
+
+			rigid_body.acceleration += -rigid_body.velocity * particle_drag_force;
+			rigid_body.velocity		+= suction * dt;
+			rigid_body.velocity		+= wind * dt;
+			transform.position		+= rigid_body.velocity * dt;
+			transform.rotation		+= turn_speed * dt;
+
+			rigid_body.velocity = {};
+
+			if (inner_deletion_circle.Overlaps(transform.position) ||
+				!outer_deletion_circle.Overlaps(transform.position)) {
+				available_entities.push_back(e);
+			}
+		}
+		while (!available_entities.empty()) {
+			auto particle{ available_entities.back() };
+			available_entities.pop_back();
+			particle.Get<Transform>().position = tornado_pos + V2_float{ rng_pos(), rng_pos() };
+		}
+	}
+
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+double BenchmarkSoa(std::size_t particle_count) {
+	DebrisParticles particles;
+	particles.SetCapacity(particle_count);
+
+	RNG<float> rng_pos{ -gravity_radius * 0.5f, gravity_radius * 0.5f };
+
+	auto spawn = [&]() {
+		while (particles.Spawn(tornado_pos.x + rng_pos(), tornado_pos.y + rng_pos(), 0.0f, 0.0f)) {}
+	};
+
+	spawn();
+
+	float inner_deletion_radius{ escape_radius * 0.1f };
+
+	DebrisForces forces;
+	forces.center_x		 = tornado_pos.x;
+	forces.center_y		 = tornado_pos.y;
+	forces.suction		 = escape_radius * particle_max_thrust;
+	forces.wind			 = escape_radius * wind_constant * turn_speed / particle_pull_resistance;
+	forces.turn_speed	 = turn_speed;
+	forces.inner_radius2 = inner_deletion_radius * inner_deletion_radius;
+	forces.outer_radius2 = gravity_radius * gravity_radius;
+
+	auto start{ Clock::now() };
+
+	for (int frame{ 0 }; frame < frames; frame++) {
+		particles.Update(forces, dt);
+		spawn();
+	}
+
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+int main() {
+	const std::vector<std::size_t> particle_counts{ 300, 10'000, 100'000 };
+
+	std::cout << "particles, ecs ns/particle, soa ns/particle, speedup\n";
+
+	for (std::size_t particle_count : particle_counts) {
+		double updates{ static_cast<double>(particle_count) * frames };
+		double ecs{ BenchmarkEcs(particle_count) / updates };
+		double soa{ BenchmarkSoa(particle_count) / updates };
+		std::cout << particle_count << ", " << ecs << ", " << soa << ", " << ecs / soa << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Runs every level in resources/data/levels.json through the headless level runner twice.
+# Usage: ./run-level-benchmarks.sh <level runner executable> [input script] [budget ms] [threads] [draw order]
+# Exits with a non-zero code if any level exceeds the per step update budget or if the two runs
+# of a level end with a different result (outcome, step count, player position).
+
+if [[ -z "$1" ]]; then
+  echo "Usage: ./run-level-benchmarks.sh <level runner executable> [input script] [budget ms] [threads] [draw order]"
+  exit 1
+fi
+
+runner="$(realpath "$1")"
+# Cooked by the build next to the runner executable.
+database="$(dirname "$runner")/data/levels.bin"
+input_script="${2:-resources/data/input_scripts/drive_north.json}"
+budget_ms="${3:-0}"
+# 0 uses every hardware thread, 1 runs the tornado update serially for comparison.
+threads="${4:-0}"
+# "submission" draws world sprites unsorted, the order used before the draw queue.
+draw_order="${5:-sorted}"
+
+cd "$(dirname "$0")/.."
+
+levels=$(grep -o '"id": *[0-9]*' resources/data/levels.json | grep -o '[0-9]*')
+
+# Without a display (e.g. in CI) the runner renders through Xvfb with software OpenGL.
+launcher=""
+if [[ -z "$DISPLAY" ]]; then
+  if [[ -z $(which xvfb-run) ]]; then
+    echo "No display and no xvfb-run detected."
+    exit 1
+  fi
+  launcher="xvfb-run -a"
+  export LIBGL_ALWAYS_SOFTWARE=1
+fi
+
+export SDL_AUDIODRIVER="${SDL_AUDIODRIVER:-dummy}"
+
+failed=0
+
+log="$(mktemp)"
+trap 'rm -f "$log"' EXIT
+
+for level in $levels; do
+  previous_result=""
+  for run in 1 2; do
+    echo "Running level $level (run $run of 2)"
+    if ! $launcher "$runner" --database "$database" --level "$level" --input "$input_script" --budget-ms "$budget_ms" --threads "$threads" --draw-order "$draw_order" > "$log" 2>&1; then
+      failed=1
+    fi
+    cat "$log"
+    result="$(grep -o 'Result: .*' "$log")"
+    if [[ -z "$result" ]]; then
+      echo "Level $level did not print a result"
+      failed=1
+    elif [[ $run -eq 2 && "$result" != "$previous_result" ]]; then
+      echo "Level $level is not reproducible, the runs ended with:"
+      echo "  $previous_result"
+      echo "  $result"
+      failed=1
+    fi
+    previous_result="$result"
+  done
+done
+
+exit $failed
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Runs one level through the headless level runner with 1, 2 and 4 job system threads.
+# Level 10 is the many tornado benchmark level, which is not part of any level select branch.
+# Exits with a non-zero code if the thread count changes the result of the run.
+# Usage: ./run-thread-scaling.sh <level runner executable> [level] [input script]
+
+if [[ -z "$1" ]]; then
+  echo "Usage: ./run-thread-scaling.sh <level runner executable> [level] [input script]"
+  exit 1
+fi
+
+runner="$(realpath "$1")"
+# Cooked by the build next to the runner executable.
+database="$(dirname "$runner")/data/levels.bin"
+level="${2:-10}"
+input_script="${3:-resources/data/input_scripts/drive_north.json}"
+
+cd "$(dirname "$0")/.."
+
+# Without a display (e.g. in CI) the runner renders through Xvfb with software OpenGL.
+launcher=""
+if [[ -z "$DISPLAY" ]]; then
+  if [[ -z $(which xvfb-run) ]]; then
+    echo "No display and no xvfb-run detected."
+    exit 1
+  fi
+  launcher="xvfb-run -a"
+  export LIBGL_ALWAYS_SOFTWARE=1
+fi
+
+export SDL_AUDIODRIVER="${SDL_AUDIODRIVER:-dummy}"
+
+failed=0
+
+log="$(mktemp)"
+trap 'rm -f "$log"' EXIT
+
+serial_result=""
+
+for threads in 1 2 4; do
+  echo "Running level $level with $threads threads"
+  if ! $launcher "$runner" --database "$database" --level "$level" --input "$input_script" --threads "$threads" > "$log" 2>&1; then
+    failed=1
+  fi
+  cat "$log"
+  result="$(grep -o 'Result: .*' "$log")"
+  if [[ -z "$serial_result" ]]; then
+    serial_result="$result"
+  elif [[ "$result" != "$serial_result" ]]; then
+    echo "Level $level ended differently with $threads threads:"
+    echo "  1 thread:  $serial_result"
+    echo "  $threads threads: $result"
+    failed=1
+  fi
+done
+
+exit $failed
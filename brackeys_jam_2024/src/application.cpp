@@ -1,35 +1,101 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <random>
 #include <set>
-#include <unordered_set>
-
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "debris_particles.h"
+#include "draw_queue.h"
+#include "job_system.h"
+#include "level_database.h"
+#include "parallel_noise.h"
 #include "protegon/protegon.h"
+#include "wind_field.h"
 
 using namespace ptgn;
 
-const path level_json = "resources/data/levels.json";
+// Cooked from resources/data/levels.json by the level_cooker build step into the build
+// directory. Overridden by the level runner's --database argument.
+path level_database_path = "data/levels.bin";
 
-std::ifstream json_file_open(level_json);
-json json_level_data = json::parse(json_file_open);
+const level_database::LevelDatabase& GetLevelDatabase() {
+	static const level_database::LevelDatabase database{ level_database_path };
+	return database;
+}
 
-constexpr V2_int resolution{ 1440, 810 };
-constexpr V2_int center{ resolution / 2 };
-constexpr bool draw_hitboxes{ false };
+// Threads used by the job system, 0 uses the hardware concurrency. Set by the level runner.
+std::size_t job_thread_count{ 0 };
 
-const auto& volume_sliders = json_level_data.at("volume");
+JobSystem& GetJobSystem() {
+	static JobSystem job_system{ job_thread_count };
+	return job_system;
+}
 
-float car_volume_frac{ volume_sliders.at("car") };
-float music_volume_frac{ volume_sliders.at("music") };
-float tornadoes_max_volume_frac{ volume_sliders.at("tornadoes_max") };
-float tornadoes_ambient_volume_frac{ volume_sliders.at("tornadoes_ambient") };
+// Uniform floats drawn from a generator seeded by the level. Unlike RNG, which is randomly
+// seeded, two runs of the same level draw the same numbers.
+class SeededRNG {
+public:
+	SeededRNG() = default;
 
-float car_volume_frac_clamped				= std::clamp(car_volume_frac, 0.0f, 1.0f);
-float music_volume_frac_clamped				= std::clamp(music_volume_frac, 0.0f, 1.0f);
-float tornadoes_max_volume_frac_clamped		= std::clamp(tornadoes_max_volume_frac, 0.0f, 1.0f);
-float tornadoes_ambient_volume_frac_clamped = std::clamp(tornadoes_ambient_volume_frac, 0.0f, 1.0f);
+	SeededRNG(std::uint32_t seed, float min, float max) :
+		generator{ seed }, distribution{ min, max } {}
 
-int car_volume{ static_cast<int>(128.0f * car_volume_frac_clamped) };
-int music_volume{ static_cast<int>(128.0f * music_volume_frac_clamped) };
-int min_tornado_volume{ static_cast<int>(128.0f * tornadoes_ambient_volume_frac_clamped) };
-int max_tornado_volume{ static_cast<int>(128.0f * tornadoes_max_volume_frac_clamped) };
+	float operator()() {
+		return distribution(generator);
+	}
+
+private:
+	std::mt19937 generator;
+	std::uniform_real_distribution<float> distribution;
+};
+
+constexpr V2_int resolution{ 1440, 810 };
+constexpr V2_int center{ resolution / 2 };
+constexpr V2_int level_tile_size{ 16, 16 };
+constexpr bool draw_hitboxes{ false };
+constexpr bool log_background_draw_calls{ false };
+constexpr bool log_draw_batches{ false };
+// Simulation steps per second, independent of the display rate.
+constexpr float simulation_rate{ 60.0f };
+
+// Set from the level database header by LoadLevelDatabase.
+int car_volume{ 0 };
+int music_volume{ 0 };
+int min_tornado_volume{ 0 };
+int max_tornado_volume{ 0 };
+
+// Opens the level database before the first scene and applies its volume sliders. A missing,
+// stale or corrupt database is logged and returns false instead of terminating the game.
+bool LoadLevelDatabase() {
+	try {
+		const auto& volume_sliders{ GetLevelDatabase().GetHeader() };
+
+		auto to_volume = [](float fraction) {
+			return static_cast<int>(128.0f * std::clamp(fraction, 0.0f, 1.0f));
+		};
+
+		car_volume		   = to_volume(volume_sliders.car_volume);
+		music_volume	   = to_volume(volume_sliders.music_volume);
+		min_tornado_volume = to_volume(volume_sliders.tornadoes_ambient_volume);
+		max_tornado_volume = to_volume(volume_sliders.tornadoes_max_volume);
+	} catch (const std::runtime_error& error) {
+		PTGN_LOG("Failed to load level database: ", error.what());
+		return false;
+	}
+	return true;
+}
 
 static void LoadMainMenu();
 static int GetCurrentGameLevel();
@@ -75,6 +141,603 @@ std::size_t GetTileKey(TileType tile_type) {
 	}
 }
 
+// Per level tile state with one byte per tile, stored in fixed size chunks. The lower bits of
+// each byte store the base tile type, which is computed once from the level noise, while the
+// upper bits store flags that are updated in place as the level is played.
+//
+// Chunks are either all created up front from noise maps covering the level, or streamed:
+// generated on demand around the camera (on a worker thread where available) and evicted once
+// far away. Destroyed tiles are also recorded in a sparse per chunk bitset so that destruction
+// applies to chunks which are not resident and survives their eviction.
+class TileGrid {
+public:
+	constexpr static int chunk_width{ 16 };
+	constexpr static int chunk_height{ 16 };
+	constexpr static V2_int chunk_size{ chunk_width, chunk_height };
+	constexpr static std::size_t chunk_tile_count{ chunk_width * chunk_height };
+
+	constexpr static std::uint8_t type_mask{ 0x0F };
+	constexpr static std::uint8_t destroyed_flag{ 1 << 4 };
+	constexpr static std::uint8_t animated_flag{ 1 << 5 };
+
+	static_assert(static_cast<std::uint8_t>(TileType::None) <= type_mask);
+
+	// Row major tiles of a single chunk.
+	using ChunkTiles = std::array<std::uint8_t, chunk_tile_count>;
+
+	// Generates the base tile types of the chunk at the given chunk coordinate. Streamed grids
+	// call this from worker threads.
+	using ChunkGenerator = std::function<ChunkTiles(const V2_int& chunk)>;
+
+	// Chunks within this many chunks of the visible ones are generated ahead of time.
+	constexpr static int prefetch_margin{ 1 };
+	// Chunks further than this many chunks from the visible ones are evicted.
+	constexpr static int eviction_margin{ 3 };
+
+	[[nodiscard]] static std::uint8_t ClassifyTile(float noise_value, float grass_noise_value) {
+		PTGN_ASSERT(noise_value >= 0.0f && noise_value <= 1.0f);
+		TileType tile_type = GetTileType(noise_value);
+		if (tile_type == TileType::Grass && grass_noise_value >= 0.65f) {
+			tile_type = TileType::TallGrass;
+		}
+		return static_cast<std::uint8_t>(tile_type);
+	}
+
+	// Creates every chunk up front from noise maps covering the whole grid.
+	void Create(
+		const V2_int& grid_size, const std::vector<float>& noise_map,
+		const std::vector<float>& grass_noise_map
+	) {
+		Reset(grid_size);
+
+		PTGN_ASSERT(noise_map.size() == static_cast<std::size_t>(size.x) * size.y);
+		PTGN_ASSERT(grass_noise_map.size() == noise_map.size());
+
+		for (int cx{ 0 }; cx < chunk_count.x; cx++) {
+			for (int cy{ 0 }; cy < chunk_count.y; cy++) {
+				V2_int first_tile{ V2_int{ cx, cy } * chunk_size };
+				ChunkTiles chunk_tiles;
+				chunk_tiles.fill(static_cast<std::uint8_t>(TileType::None));
+				for (int j{ 0 }; j < chunk_height; j++) {
+					for (int i{ 0 }; i < chunk_width; i++) {
+						V2_int tile{ first_tile + V2_int{ i, j } };
+						if (!Contains(tile)) {
+							continue;
+						}
+						std::size_t index{ static_cast<std::size_t>(tile.x) +
+										   static_cast<std::size_t>(size.x) * tile.y };
+						chunk_tiles[GetLocalIndex(tile)] =
+							ClassifyTile(noise_map[index], grass_noise_map[index]);
+					}
+				}
+				Install(GetChunkIndex({ cx, cy }), chunk_tiles);
+			}
+		}
+	}
+
+	// Creates a grid whose chunks are generated on demand by Stream().
+	void CreateStreamed(const V2_int& grid_size, const ChunkGenerator& chunk_generator) {
+		Reset(grid_size);
+		PTGN_ASSERT(chunk_generator != nullptr);
+		generator = chunk_generator;
+	}
+
+	[[nodiscard]] bool IsStreamed() const {
+		return generator != nullptr;
+	}
+
+	// Makes every chunk overlapping the tile range [min, max) resident, starts generating the
+	// chunks around it and evicts far away chunks. Does nothing for grids which are not streamed.
+	// @param evicted Filled with the coordinates of evicted chunks.
+	void Stream(const V2_int& min, const V2_int& max, std::vector<V2_int>& evicted) {
+		evicted.clear();
+
+		if (!IsStreamed() || max.x <= min.x || max.y <= min.y) {
+			return;
+		}
+
+		V2_int min_chunk{ GetChunk(min) };
+		V2_int max_chunk{ GetChunk(max - V2_int{ 1, 1 }) };
+
+		// Adopt chunks which finished generating in the background.
+		for (std::size_t i{ 0 }; i < pending_chunks.size();) {
+			auto& pending{ pending_chunks[i] };
+			if (pending.tiles.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+				i++;
+				continue;
+			}
+			Install(pending.index, pending.tiles.get());
+			pending = std::move(pending_chunks.back());
+			pending_chunks.pop_back();
+		}
+
+		// Visible chunks cannot wait for the next frame.
+		for (int cx{ min_chunk.x }; cx <= max_chunk.x; cx++) {
+			for (int cy{ min_chunk.y }; cy <= max_chunk.y; cy++) {
+				std::size_t index{ GetChunkIndex({ cx, cy }) };
+				if (chunks[index] != nullptr) {
+					continue;
+				}
+				if (auto it{ FindPending(index) }; it != pending_chunks.end()) {
+					Install(index, it->tiles.get());
+					pending_chunks.erase(it);
+				} else {
+					Install(index, generator({ cx, cy }));
+				}
+			}
+		}
+
+		V2_int prefetch_min{ ClampChunk(min_chunk - V2_int{ prefetch_margin, prefetch_margin }) };
+		V2_int prefetch_max{ ClampChunk(max_chunk + V2_int{ prefetch_margin, prefetch_margin }) };
+
+		for (int cx{ prefetch_min.x }; cx <= prefetch_max.x; cx++) {
+			for (int cy{ prefetch_min.y }; cy <= prefetch_max.y; cy++) {
+				std::size_t index{ GetChunkIndex({ cx, cy }) };
+				if (chunks[index] != nullptr || FindPending(index) != pending_chunks.end()) {
+					continue;
+				}
+#ifdef __EMSCRIPTEN__
+				// Web builds are compiled without pthread support.
+				Install(index, generator({ cx, cy }));
+#else
+				pending_chunks.push_back(
+					{ index, std::async(std::launch::async, generator, V2_int{ cx, cy }) }
+				);
+#endif
+			}
+		}
+
+		V2_int keep_min{ min_chunk - V2_int{ eviction_margin, eviction_margin } };
+		V2_int keep_max{ max_chunk + V2_int{ eviction_margin, eviction_margin } };
+
+		for (std::size_t i{ 0 }; i < resident_chunks.size();) {
+			std::size_t index{ resident_chunks[i] };
+			V2_int chunk{ static_cast<int>(index % chunk_count.x),
+						  static_cast<int>(index / chunk_count.x) };
+			if (chunk.x >= keep_min.x && chunk.y >= keep_min.y && chunk.x <= keep_max.x &&
+				chunk.y <= keep_max.y) {
+				i++;
+				continue;
+			}
+			chunks[index].reset();
+			evicted.push_back(chunk);
+			resident_chunks[i] = resident_chunks.back();
+			resident_chunks.pop_back();
+		}
+	}
+
+	[[nodiscard]] const V2_int& GetSize() const {
+		return size;
+	}
+
+	[[nodiscard]] bool Contains(const V2_int& tile) const {
+		return tile.x >= 0 && tile.y >= 0 && tile.x < size.x && tile.y < size.y;
+	}
+
+	[[nodiscard]] bool IsResident(const V2_int& chunk) const {
+		return chunk.x >= 0 && chunk.y >= 0 && chunk.x < chunk_count.x &&
+			   chunk.y < chunk_count.y && chunks[GetChunkIndex(chunk)] != nullptr;
+	}
+
+	// @return TileType::None if the tile is outside of the grid or not resident.
+	[[nodiscard]] TileType GetBaseType(const V2_int& tile) const {
+		const std::uint8_t* value{ GetTile(tile) };
+		if (value == nullptr) {
+			return TileType::None;
+		}
+		return static_cast<TileType>(*value & type_mask);
+	}
+
+	// @return Tile type after destruction is taken into account.
+	[[nodiscard]] TileType GetType(const V2_int& tile) const {
+		const std::uint8_t* value{ GetTile(tile) };
+		if (value == nullptr) {
+			return TileType::None;
+		}
+		auto tile_type{ static_cast<TileType>(*value & type_mask) };
+		if ((*value & destroyed_flag) == 0) {
+			return tile_type;
+		}
+		return tile_type == TileType::House ? TileType::HouseDestroyed : TileType::Dirt;
+	}
+
+	[[nodiscard]] bool IsAnimated(const V2_int& tile) const {
+		const std::uint8_t* value{ GetTile(tile) };
+		return value != nullptr && (*value & animated_flag) != 0;
+	}
+
+	// Tiles which are not resident are destroyed once their chunk is generated.
+	// @return True if the tile was not already destroyed.
+	bool SetDestroyed(const V2_int& tile) {
+		if (!Contains(tile)) {
+			return false;
+		}
+		std::uint8_t* value{ GetTile(tile) };
+		if (value != nullptr) {
+			if ((*value & destroyed_flag) != 0) {
+				return false;
+			}
+			*value |= destroyed_flag;
+		}
+		// Chunks of grids which are not streamed are never evicted.
+		if (!IsStreamed()) {
+			return true;
+		}
+		auto& destroyed{ destroyed_tiles[GetChunkIndex(GetChunk(tile))] };
+		std::size_t local_index{ GetLocalIndex(tile) };
+		if (destroyed.test(local_index)) {
+			return false;
+		}
+		destroyed.set(local_index);
+		return true;
+	}
+
+	// @return True if the tile was not already animated.
+	bool SetAnimated(const V2_int& tile) {
+		std::uint8_t* value{ GetTile(tile) };
+		if (value == nullptr || (*value & animated_flag) != 0) {
+			return false;
+		}
+		*value |= animated_flag;
+		return true;
+	}
+
+	void ClearAnimated(const V2_int& tile) {
+		std::uint8_t* value{ GetTile(tile) };
+		if (value == nullptr) {
+			return;
+		}
+		*value &= static_cast<std::uint8_t>(~animated_flag);
+	}
+
+	// Clears the destruction and animation of every tile, leaving the generated base types.
+	void ResetFlags() {
+		for (std::size_t index : resident_chunks) {
+			for (auto& value : *chunks[index]) {
+				value &= type_mask;
+			}
+		}
+		destroyed_tiles.clear();
+	}
+
+private:
+	struct PendingChunk {
+		std::size_t index{ 0 };
+		std::future<ChunkTiles> tiles;
+	};
+
+	void Reset(const V2_int& grid_size) {
+		PTGN_ASSERT(grid_size.x > 0 && grid_size.y > 0);
+		size		= grid_size;
+		chunk_count = { (size.x + chunk_width - 1) / chunk_width,
+						(size.y + chunk_height - 1) / chunk_height };
+		generator	= {};
+		// Wait for any outstanding generation before its results are discarded.
+		pending_chunks.clear();
+		chunks.clear();
+		chunks.resize(static_cast<std::size_t>(chunk_count.x) * chunk_count.y);
+		resident_chunks.clear();
+		destroyed_tiles.clear();
+	}
+
+	void Install(std::size_t index, const ChunkTiles& generated) {
+		PTGN_ASSERT(chunks[index] == nullptr);
+		auto chunk_tiles{ std::make_unique<ChunkTiles>(generated) };
+		if (auto it{ destroyed_tiles.find(index) }; it != destroyed_tiles.end()) {
+			for (std::size_t i{ 0 }; i < chunk_tile_count; i++) {
+				if (it->second.test(i)) {
+					(*chunk_tiles)[i] |= destroyed_flag;
+				}
+			}
+		}
+		chunks[index] = std::move(chunk_tiles);
+		resident_chunks.push_back(index);
+	}
+
+	[[nodiscard]] std::vector<PendingChunk>::iterator FindPending(std::size_t index) {
+		return std::find_if(
+			pending_chunks.begin(), pending_chunks.end(),
+			[=](const PendingChunk& pending) { return pending.index == index; }
+		);
+	}
+
+	[[nodiscard]] V2_int ClampChunk(const V2_int& chunk) const {
+		return { std::clamp(chunk.x, 0, chunk_count.x - 1),
+				 std::clamp(chunk.y, 0, chunk_count.y - 1) };
+	}
+
+	[[nodiscard]] V2_int GetChunk(const V2_int& tile) const {
+		return ClampChunk({ tile.x / chunk_width, tile.y / chunk_height });
+	}
+
+	[[nodiscard]] std::size_t GetChunkIndex(const V2_int& chunk) const {
+		return static_cast<std::size_t>(chunk.x) +
+			   static_cast<std::size_t>(chunk_count.x) * chunk.y;
+	}
+
+	[[nodiscard]] static std::size_t GetLocalIndex(const V2_int& tile) {
+		return static_cast<std::size_t>(tile.x % chunk_width) +
+			   static_cast<std::size_t>(chunk_width) * (tile.y % chunk_height);
+	}
+
+	// @return nullptr if the tile is outside of the grid or its chunk is not resident.
+	[[nodiscard]] const std::uint8_t* GetTile(const V2_int& tile) const {
+		if (!Contains(tile)) {
+			return nullptr;
+		}
+		const auto& chunk_tiles{ chunks[GetChunkIndex(GetChunk(tile))] };
+		if (chunk_tiles == nullptr) {
+			return nullptr;
+		}
+		return &(*chunk_tiles)[GetLocalIndex(tile)];
+	}
+
+	[[nodiscard]] std::uint8_t* GetTile(const V2_int& tile) {
+		return const_cast<std::uint8_t*>(std::as_const(*this).GetTile(tile));
+	}
+
+	V2_int size;
+	V2_int chunk_count;
+	std::vector<std::unique_ptr<ChunkTiles>> chunks;
+	std::vector<std::size_t> resident_chunks;
+	std::vector<PendingChunk> pending_chunks;
+	std::unordered_map<std::size_t, std::bitset<chunk_tile_count>> destroyed_tiles;
+	ChunkGenerator generator;
+};
+
+// Running tall grass animations. Each entry stores when its tile started animating and the
+// sprite sheet column to draw, which is derived from the frame clock in Update(). The tile grid
+// animated flag is kept in sync so a tile is never animated twice at the same time.
+class TileAnimations {
+public:
+	struct Animation {
+		V2_int tile;
+		float start{ 0.0f };
+		int column{ 0 };
+	};
+
+	TileAnimations() = default;
+
+	// @param duration Time in seconds for the animation to reach its last column. The animation
+	// then plays in reverse for the same duration.
+	TileAnimations(float duration, int columns) : duration{ duration }, columns{ columns } {
+		PTGN_ASSERT(duration > 0.0f);
+		PTGN_ASSERT(columns > 0);
+	}
+
+	void Start(const V2_int& tile, float time) {
+		animations.push_back({ tile, time, 0 });
+	}
+
+	// Stops all animations without updating the tile grid animated flags.
+	void Clear() {
+		animations.clear();
+	}
+
+	// Updates the columns of all animations and swap removes finished ones.
+	void Update(float time, TileGrid& tiles) {
+		std::size_t i{ 0 };
+		while (i < animations.size()) {
+			Animation& animation{ animations[i] };
+			float elapsed{ (time - animation.start) / duration };
+			if (elapsed >= 2.0f) {
+				tiles.ClearAnimated(animation.tile);
+				animation = animations.back();
+				animations.pop_back();
+				continue;
+			}
+			float f{ elapsed <= 1.0f ? elapsed : 2.0f - elapsed };
+			animation.column = static_cast<int>(f * static_cast<float>(columns - 1));
+			i++;
+		}
+	}
+
+	[[nodiscard]] const std::vector<Animation>& GetAnimations() const {
+		return animations;
+	}
+
+private:
+	float duration{ 0.3f };
+	int columns{ 1 };
+	std::vector<Animation> animations;
+};
+
+// Tiles [x_min, x_max] of row y which are overlapped by a circle.
+struct TileSpan {
+	int y{ 0 };
+	int x_min{ 0 };
+	int x_max{ 0 };
+};
+
+// Replaces spans with one span per tile row overlapped by the circle, clamped to the grid.
+// Each row is resolved analytically from the row's closest point to the circle center rather
+// than by testing every tile of the circle's bounding box.
+void RasterizeCircle(
+	const V2_float& center, float radius, const V2_int& tile_size, const V2_int& grid_size,
+	std::vector<TileSpan>& spans
+) {
+	spans.clear();
+
+	if (radius <= 0.0f) {
+		return;
+	}
+
+	const auto tile_w{ static_cast<float>(tile_size.x) };
+	const auto tile_h{ static_cast<float>(tile_size.y) };
+
+	int row_min{ std::max(0, static_cast<int>(std::floor((center.y - radius) / tile_h))) };
+	int row_max{ std::min(
+		grid_size.y - 1, static_cast<int>(std::floor((center.y + radius) / tile_h))
+	) };
+
+	float radius2{ radius * radius };
+
+	for (int j{ row_min }; j <= row_max; j++) {
+		float row_top{ j * tile_h };
+		float closest_y{ std::clamp(center.y, row_top, row_top + tile_h) };
+		float dy{ center.y - closest_y };
+		float half_width2{ radius2 - dy * dy };
+		if (half_width2 < 0.0f) {
+			continue;
+		}
+		float half_width{ std::sqrt(half_width2) };
+
+		int x_min{ std::max(0, static_cast<int>(std::floor((center.x - half_width) / tile_w))) };
+		int x_max{ std::min(
+			grid_size.x - 1, static_cast<int>(std::floor((center.x + half_width) / tile_w))
+		) };
+
+		if (x_min > x_max) {
+			continue;
+		}
+
+		spans.push_back({ j, x_min, x_max });
+	}
+}
+
+// Static background tiles baked into fixed size chunks so that drawing the visible background
+// costs one draw call per chunk instead of one per tile. A chunk is only rebaked after one of
+// its tiles has been invalidated.
+class BackgroundChunks {
+public:
+	// In tiles. Matches the tile grid chunks so that streaming can evict both together.
+	constexpr static V2_int chunk_size{ TileGrid::chunk_size };
+
+	void Create(const V2_int& grid_size, const V2_int& tile_size) {
+		this->tile_size = tile_size;
+		chunk_count		= { (grid_size.x + chunk_size.x - 1) / chunk_size.x,
+							(grid_size.y + chunk_size.y - 1) / chunk_size.y };
+		chunks.clear();
+		chunks.resize(static_cast<std::size_t>(chunk_count.x) * chunk_count.y);
+	}
+
+	void Invalidate(const V2_int& tile) {
+		V2_int chunk{ tile.x / chunk_size.x, tile.y / chunk_size.y };
+		if (!Contains(chunk)) {
+			return;
+		}
+		GetChunk(chunk).dirty = true;
+	}
+
+	void InvalidateAll() {
+		for (auto& chunk : chunks) {
+			chunk.dirty = true;
+		}
+	}
+
+	// Releases the baked render target of a chunk whose tiles were evicted.
+	void Evict(const V2_int& chunk) {
+		if (!Contains(chunk)) {
+			return;
+		}
+		GetChunk(chunk) = {};
+	}
+
+	// Queues all chunks overlapping the given tile range [min, max), rebaking dirty ones.
+	// @return Number of chunks queued.
+	std::size_t Draw(
+		DrawQueue& draw_queue, const V2_int& min, const V2_int& max, const TileGrid& tiles,
+		const std::array<Texture, static_cast<std::size_t>(TileType::None)>& tile_textures
+	) {
+		if (max.x <= min.x || max.y <= min.y) {
+			return 0;
+		}
+
+		V2_int min_chunk{ min.x / chunk_size.x, min.y / chunk_size.y };
+		V2_int max_chunk{ (max.x - 1) / chunk_size.x, (max.y - 1) / chunk_size.y };
+
+		V2_int chunk_pixel_size{ chunk_size * tile_size };
+
+		std::size_t draw_calls{ 0 };
+
+		for (int i{ min_chunk.x }; i <= max_chunk.x; i++) {
+			for (int j{ min_chunk.y }; j <= max_chunk.y; j++) {
+				V2_int coordinate{ i, j };
+				if (!Contains(coordinate) || !tiles.IsResident(coordinate)) {
+					continue;
+				}
+				Chunk& chunk{ GetChunk(coordinate) };
+				if (chunk.dirty) {
+					Bake(coordinate, chunk, tiles, tile_textures);
+				}
+				draw_queue.Add(
+					chunk.target.GetTexture(), coordinate * chunk_pixel_size, chunk_pixel_size,
+					{}, {}, Origin::TopLeft, Flip::None, 0.0f, { 0.5f, 0.5f }, 0
+				);
+				draw_calls++;
+			}
+		}
+
+		return draw_calls;
+	}
+
+private:
+	struct Chunk {
+		RenderTarget target;
+		bool baked{ false };
+		bool dirty{ true };
+	};
+
+	[[nodiscard]] bool Contains(const V2_int& chunk) const {
+		return chunk.x >= 0 && chunk.y >= 0 && chunk.x < chunk_count.x && chunk.y < chunk_count.y;
+	}
+
+	[[nodiscard]] Chunk& GetChunk(const V2_int& chunk) {
+		PTGN_ASSERT(Contains(chunk));
+		return chunks
+			[static_cast<std::size_t>(chunk.x) + static_cast<std::size_t>(chunk_count.x) * chunk.y];
+	}
+
+	void Bake(
+		const V2_int& coordinate, Chunk& chunk, const TileGrid& tiles,
+		const std::array<Texture, static_cast<std::size_t>(TileType::None)>& tile_textures
+	) {
+		if (!chunk.baked) {
+			chunk.target = RenderTarget{ chunk_size * tile_size, color::Transparent };
+			chunk.target.SetCamera({});
+			chunk.baked = true;
+		}
+
+		V2_int first_tile{ coordinate * chunk_size };
+
+		// Flush pending draws so they are not redirected into the chunk.
+		game.renderer.Flush();
+		game.renderer.SetRenderTarget(chunk.target);
+
+		for (int i{ 0 }; i < chunk_size.x; i++) {
+			for (int j{ 0 }; j < chunk_size.y; j++) {
+				V2_int local{ i, j };
+				TileType tile_type{ tiles.GetType(first_tile + local) };
+				if (tile_type == TileType::None) {
+					continue;
+				}
+				const Texture& t = tile_textures[static_cast<std::size_t>(tile_type)];
+				if (tile_type == TileType::TallGrass) {
+					// Only the first animation column is static.
+					game.renderer.DrawTexture(
+						t, local * tile_size, tile_size, {}, tile_size, Origin::TopLeft,
+						Flip::None, 0.0f, { 0.5f, 0.5f }, 0.0f
+					);
+				} else {
+					game.renderer.DrawTexture(
+						t, local * tile_size, tile_size, {}, {}, Origin::TopLeft, Flip::None,
+						0.0f, { 0.5f, 0.5f }, 0.0f
+					);
+				}
+			}
+		}
+
+		game.renderer.Flush();
+		game.renderer.SetRenderTarget({});
+
+		chunk.dirty = false;
+	}
+
+	V2_int tile_size;
+	V2_int chunk_count;
+	std::vector<Chunk> chunks;
+};
+
 struct Size : public V2_float {};
 
 struct Aerodynamics {
@@ -84,6 +747,9 @@ struct Aerodynamics {
 struct VehicleComponent {
 	float throttle{ 0.0f };
 	milliseconds throttle_time{ 0 };
+	// Seconds the throttle has been held in one direction, advanced by the simulation step.
+	float throttle_elapsed{ 0.0f };
+	bool throttling{ false };
 
 	float thrust{ 0.0f };
 	float backward_thrust_frac{ 0.0f };
@@ -105,42 +771,84 @@ struct TintColor : public Color {
 
 struct CameraShake {};
 
+// Transforms from before and after the latest simulation step, used to draw the entity in
+// between steps.
+struct InterpolatedTransform {
+	Transform previous;
+	Transform current;
+};
+
+// Keyframed tornado movement advanced by the simulation step, so that tornado positions only
+// depend on the number of steps simulated and not on how fast frames are rendered.
+struct TornadoPath {
+	struct Segment {
+		// Seconds.
+		float duration{ 0.0f };
+		// Position at a progress from 0 to 1 through the segment.
+		std::function<V2_float(float)> position;
+	};
+
+	std::vector<Segment> segments;
+
+	// Seconds since the tornado started moving.
+	float elapsed{ 0.0f };
+
+	// @return Position once the path has advanced by dt. Remains at the end of the last
+	// segment after the path finishes.
+	[[nodiscard]] V2_float Advance(float dt) {
+		PTGN_ASSERT(!segments.empty());
+		elapsed += dt;
+		float time{ elapsed };
+		for (const Segment& segment : segments) {
+			if (time < segment.duration) {
+				return segment.position(time / segment.duration);
+			}
+			time -= segment.duration;
+		}
+		return segments.back().position(1.0f);
+	}
+};
+
+// Flashes the dirty vehicle texture and shakes the camera while the player is within a warning
+// radius. Advanced by the simulation step rather than frame time, like the rest of the level.
 struct Warning {
-	void Init(ecs::Entity player) {
-		game.tween.Load(Hash("warning_flash"))
-			.During(milliseconds{ 500 })
-			.Repeat(-1)
-			.OnRepeat([=](Tween& tween) mutable {
-				if (tween.GetRepeats() % 2 == 0) {
-					if (player.Has<VehicleComponent>()) {
-						auto& v	  = player.Get<VehicleComponent>();
-						v.texture = v.vehicle_dirty_texture;
-					}
-					player.Add<CameraShake>();
-				} else {
-					if (player.Has<VehicleComponent>()) {
-						auto& v	  = player.Get<VehicleComponent>();
-						v.texture = v.vehicle_texture;
-					}
-					// player.Remove<TintColor>();
-					player.Remove<CameraShake>();
-				}
-			})
-			.OnStop([=]() mutable {
-				if (player.Has<VehicleComponent>()) {
-					auto& v	  = player.Get<VehicleComponent>();
-					v.texture = v.vehicle_texture;
-				}
-				// player.Remove<TintColor>();
-				player.Remove<CameraShake>();
-			})
-			.Start();
+	ecs::Entity player;
+
+	// Seconds into the current flash.
+	float elapsed{ 0.0f };
+	int flashes{ 0 };
+
+	constexpr static float flash_duration{ 0.5f };
+
+	void Init(ecs::Entity warned_player) {
+		player = warned_player;
+	}
+
+	void Update(float dt) {
+		elapsed += dt;
+		while (elapsed >= flash_duration) {
+			elapsed -= flash_duration;
+			SetFlash(flashes % 2 == 0);
+			flashes++;
+		}
 	}
 
 	void Shutdown() {
-		PTGN_ASSERT(game.tween.Has(Hash("warning_flash")));
-		game.tween.Get(Hash("warning_flash")).Stop();
-		game.tween.Unload("warning_flash");
+		SetFlash(false);
+	}
+
+private:
+	void SetFlash(bool on) {
+		if (player.Has<VehicleComponent>()) {
+			auto& v	  = player.Get<VehicleComponent>();
+			v.texture = on ? v.vehicle_dirty_texture : v.vehicle_texture;
+		}
+		// player.Remove<TintColor>();
+		if (on) {
+			player.Add<CameraShake>();
+		} else {
+			player.Remove<CameraShake>();
+		}
 	}
 };
 
@@ -210,6 +918,19 @@ struct TornadoComponent {
 		return suction;
 	}
 
+	// Terms of GetSuction() and GetWind() which do not depend on the target.
+	WindSource GetWindSource(const V2_float& position, const V2_float& velocity) const {
+		WindSource source;
+		source.x		  = position.x;
+		source.y		  = position.y;
+		source.velocity_x = velocity.x;
+		source.velocity_y = velocity.y;
+		source.suction	  = escape_radius;
+		source.wind		  = escape_radius * wind_constant * turn_speed;
+		source.radius	  = gravity_radius;
+		return source;
+	}
+
 	V2_float GetWind(const V2_float& direction, float pull_resistance) const {
 		float dist2{ direction.MagnitudeSquared() };
 
@@ -222,112 +943,162 @@ struct TornadoComponent {
 		return wind;
 	}
 
-	ecs::Manager particle_manager;
-
-	std::vector<ecs::Entity> available_entities;
+	DebrisParticles particles;
 
 	std::size_t max_particles{ 300 };
 
 	// TODO: Make this a vector and choose randomly from that vector.
 	Texture particle_texture{ "resources/entity/tornado_particle_1.png" };
 
-	Timer particle_spawn_timer;
+	// Spawn positions within the escape radius, seeded per tornado by CreateTornado(). Each
+	// tornado owns its generator, so the job system's scheduling does not change the draws.
+	SeededRNG particle_rng;
+
+	// Seconds into the current spawn cycle, advanced by the simulation step. Negative until
+	// the first particles are spawned.
+	float particle_spawn_time{ -1.0f };
 
 	constexpr static float particle_launch_speed{ 0.0f };
 
-	milliseconds particle_spawn_cycle{ 100 };
+	// Seconds per spawn cycle, particles are spawned during the first half of each cycle.
+	float particle_spawn_cycle{ 0.1f };
+
+	// Fraction of max_particles kept when the gravity radius only just overlaps the view.
+	constexpr static float min_particle_fraction{ 0.25f };
+
+	// Set while the gravity radius, which bounds the particles, is entirely outside the view.
+	// Culled particles are not simulated, instead they follow the tornado as a group.
+	bool particles_culled{ false };
+	V2_float culled_position;
+	float culled_rotation{ 0.0f };
+
+	// Distance from position to the closest point of rect, 0 if position is inside.
+	static float GetDistance(const V2_float& position, const Rect& rect) {
+		V2_float min{ rect.Min() };
+		V2_float max{ rect.Max() };
+		V2_float outside{ std::max({ min.x - position.x, 0.0f, position.x - max.x }),
+						  std::max({ min.y - position.y, 0.0f, position.y - max.y }) };
+		return outside.Magnitude();
+	}
 
-	void CreateParticles(ecs::Entity tornado) {
+	void CreateParticles(ecs::Entity tornado, std::size_t particle_limit) {
 		PTGN_ASSERT(tornado.Has<Transform>());
 		PTGN_ASSERT(tornado.Has<RigidBody>());
 		V2_float tornado_pos{ tornado.Get<Transform>().position };
 		V2_float tornado_vel{ tornado.Get<RigidBody>().velocity };
-		RNG<float> rng_pos{ -escape_radius, escape_radius };
-
-		if (!particle_spawn_timer.IsRunning()) {
-			particle_spawn_timer.Start();
-			available_entities.reserve(max_particles);
-			particle_manager.Reserve(max_particles);
 
-			// milliseconds particle_lifetime{ 3000 };
-
-			for (std::size_t i = 0; i < max_particles; i++) {
-				auto particle = particle_manager.CreateEntity();
-				available_entities.push_back(particle);
-				auto& transform = particle.Add<Transform>();
-				V2_float heading{ V2_float::RandomHeading() };
-				transform.position	= tornado_pos + V2_float{ rng_pos(), rng_pos() };
-				auto& rigid_body	= particle.Add<RigidBody>();
-				rigid_body.velocity = tornado_vel;
-			}
-
-			particle_manager.Refresh();
+		if (particle_spawn_time < 0.0f) {
+			particle_spawn_time = 0.0f;
+			particles.SetCapacity(max_particles);
 		}
 
-		if (particle_spawn_timer.ElapsedPercentage(particle_spawn_cycle) >= 1.0f) {
-			particle_spawn_timer.Start();
+		particles.SetLimit(particle_limit);
+
+		if (particle_spawn_time >= particle_spawn_cycle) {
+			particle_spawn_time = 0.0f;
 		}
 
-		if (particle_spawn_timer.ElapsedPercentage(particle_spawn_cycle) >= 0.5f) {
+		if (particle_spawn_time >= 0.5f * particle_spawn_cycle) {
 			return;
 		}
 
-		for (std::size_t i = 0; i < available_entities.size(); i++) {
-			ecs::Entity particle = available_entities.back();
-			available_entities.pop_back();
-			auto& transform		= particle.Get<Transform>();
-			transform.position	= tornado_pos + V2_float{ rng_pos(), rng_pos() };
-			auto& rigid_body	= particle.Get<RigidBody>();
-			rigid_body.velocity = tornado_vel;
-		}
+		// Recycled particles occupy the free slots at the end of the particle arrays.
+		while (particles.Spawn(
+			tornado_pos.x + particle_rng(), tornado_pos.y + particle_rng(), tornado_vel.x,
+			tornado_vel.y
+		)) {}
 	}
 
-	void UpdateParticles(ecs::Entity tornado) {
+	// Particle simulation and budget scale down the further the tornado is from the view.
+	// @param field Used for the particle pull instead of this tornado alone if enabled.
+	void UpdateParticles(ecs::Entity tornado, float dt, const WindField& field, const Rect& view) {
 		PTGN_ASSERT(tornado.Has<Transform>());
 
 		V2_float tornado_pos{ tornado.Get<Transform>().position };
 
-		float particle_pull_resistance{ 0.1f };
-
-		Circle inner_deletion_circle{ tornado_pos, escape_radius * 0.1f };
-		Circle outer_deletion_circle{ tornado_pos, gravity_radius };
-
-		const float particle_drag_force{ 0.01f };
-		float dt = game.dt();
+		// The spawn cycle keeps running while culled, as the wall clock timer it replaced did.
+		if (particle_spawn_time >= 0.0f) {
+			particle_spawn_time += dt;
+		}
 
-		auto particles = particle_manager.EntitiesWith<Transform, RigidBody>();
-		for (auto [e, transform, rigid_body] : particles) {
-			/*if (lifetime.Elapsed()) {
-				e.Destroy();
-				continue;
-			}*/
+		float view_distance{ GetDistance(tornado_pos, view) };
 
-			V2_float dir{ tornado_pos - transform.position };
+		if (view_distance > gravity_radius) {
+			if (!particles_culled) {
+				particles_culled = true;
+				culled_position	 = tornado_pos;
+				culled_rotation	 = 0.0f;
+			}
+			culled_rotation += turn_speed * dt;
+			return;
+		}
 
-			rigid_body.acceleration += -rigid_body.velocity * particle_drag_force;
-			rigid_body.velocity		+= GetSuction(dir, 200.0f) * dt;
-			rigid_body.velocity		+= GetWind(dir, particle_pull_resistance) * dt;
-			transform.position		+= rigid_body.velocity * dt;
-			transform.rotation		+= turn_speed * dt;
+		if (particles_culled) {
+			particles_culled = false;
+			V2_float offset{ tornado_pos - culled_position };
+			particles.Offset(offset.x, offset.y, culled_rotation);
+		}
 
-			rigid_body.velocity = {};
+		float fraction{
+			std::clamp(1.0f - view_distance / gravity_radius, min_particle_fraction, 1.0f)
+		};
+		auto particle_limit{ static_cast<std::size_t>(std::ceil(max_particles * fraction)) };
 
-			if (inner_deletion_circle.Overlaps(transform.position) ||
-				!outer_deletion_circle.Overlaps(transform.position)) {
-				available_entities.push_back(e);
-			}
+		float particle_pull_resistance{ 0.1f };
+		float particle_max_thrust{ 200.0f };
+
+		float inner_deletion_radius{ escape_radius * 0.1f };
+
+		// Same terms as GetSuction() and GetWind(), with the division by the squared distance
+		// done once per particle inside the kernel.
+		DebrisForces forces;
+		forces.center_x		 = tornado_pos.x;
+		forces.center_y		 = tornado_pos.y;
+		forces.turn_speed	 = turn_speed;
+		forces.inner_radius2 = inner_deletion_radius * inner_deletion_radius;
+		forces.outer_radius2 = gravity_radius * gravity_radius;
+
+		if (field.IsEnabled()) {
+			// The field holds the per tornado numerators, see GetWindSource().
+			forces.suction = particle_max_thrust;
+			forces.wind	   = 1.0f / particle_pull_resistance;
+			particles.Update(field, forces, dt);
+		} else {
+			forces.suction = escape_radius * particle_max_thrust;
+			forces.wind	   = escape_radius * wind_constant * turn_speed / particle_pull_resistance;
+			particles.Update(forces, dt);
 		}
 
-		CreateParticles(tornado);
+		CreateParticles(tornado, particle_limit);
 	}
 
-	void DrawParticles() {
-		auto particles = particle_manager.EntitiesWith<Transform>();
-		for (auto [e, transform] : particles) {
-			game.draw.Texture(
-				particle_texture, { transform.position, particle_texture.GetSize(), Origin::Center, transform.rotation }, { 4.0f, 0 }
-			);
+	// @return True if any particle was queued, always as a single group.
+	bool DrawParticles(DrawQueue& draw_queue, const Rect& view) {
+		if (particles_culled) {
+			return false;
+		}
+		V2_float size{ particle_texture.GetSize() };
+		// Rotated particles stay within their diagonal.
+		float margin{ size.Magnitude() / 2.0f };
+		V2_float min{ view.Min() - V2_float{ margin, margin } };
+		V2_float max{ view.Max() + V2_float{ margin, margin } };
+		// Visible particles are written straight into one queue submission, the renderer still
+		// receives a call per particle.
+		GroupedSprite* grouped{
+			draw_queue.AddGroup(particle_texture, size, particles.GetAliveCount(), 4)
+		};
+		std::size_t count{ 0 };
+		for (std::size_t i{ 0 }; i < particles.GetAliveCount(); i++) {
+			if (particles.x[i] < min.x || particles.y[i] < min.y || particles.x[i] > max.x ||
+				particles.y[i] > max.y) {
+				continue;
+			}
+			GroupedSprite& sprite{ grouped[count++] };
+			sprite.position = { particles.x[i], particles.y[i] };
+			sprite.rotation = particles.rotation[i];
 		}
+		draw_queue.TrimGroup(count);
+		return count > 0;
 	}
 };
 
@@ -545,11 +1316,10 @@ struct Progress {
 		return false;
 	}
 
-	void DecrementTornadoProgress() {
+	void DecrementTornadoProgress(float dt) {
 		if (current_tornado == ecs::null) {
 			return;
 		}
-		float dt = game.dt();
 		PTGN_ASSERT(current_tornado.Has<TornadoComponent>());
 		TornadoComponent tornado_properties{ current_tornado.Get<TornadoComponent>() };
 
@@ -561,14 +1331,14 @@ struct Progress {
 		progress  = std::clamp(progress, 0.0f, 1.0f);
 	}
 
-	void Update(ecs::Entity tornado, const V2_float& player_pos) {
+	void Update(ecs::Entity tornado, const V2_float& player_pos, float dt) {
 		if (game.tween.Has(Hash("pulled_in_tween"))) {
 			progress = 0.0f;
 			return;
 		}
 
 		if (tornado == ecs::null) {
-			DecrementTornadoProgress();
+			DecrementTornadoProgress(dt);
 			return;
 		}
 		PTGN_ASSERT(!CompletedTornado(tornado));
@@ -631,8 +1401,6 @@ struct Progress {
 			tornado_properties.outermost_increment_ratio, normalized_dist
 		) };
 
-		float dt = game.dt();
-
 		progress += tornado_properties.increment_speed * increment_ratio * dt;
 
 		progress = std::clamp(progress, 0.0f, 1.0f);
@@ -643,34 +1411,281 @@ struct Progress {
 	}
 };
 
+// Player controls for a single update step, either read from the keyboard or from an input
+// script when the level is driven by the level runner.
+struct Controls {
+	bool up{ false };
+	bool down{ false };
+	bool left{ false };
+	bool right{ false };
+	bool zoom_in{ false };
+	bool zoom_out{ false };
+	bool restart{ false };
+	bool exit{ false };
+
+	static Controls FromKeyboard() {
+		Controls controls;
+		controls.up		  = game.input.KeyPressed(Key::W);
+		controls.down	  = game.input.KeyPressed(Key::S);
+		controls.left	  = game.input.KeyPressed(Key::A);
+		controls.right	  = game.input.KeyPressed(Key::D);
+		controls.zoom_in  = game.input.KeyPressed(Key::Q);
+		controls.zoom_out = game.input.KeyPressed(Key::E);
+		controls.restart  = game.input.KeyDown(Key::R);
+		controls.exit	  = game.input.KeyDown(Key::Escape);
+		return controls;
+	}
+};
+
+// Timeline of held keys loaded from JSON in the form:
+// [ { "time": 0.0, "keys": [ "W" ] }, { "time": 2.5, "keys": [ "W", "D" ] }, ... ]
+// Each entry holds its keys from its time (in seconds) until the time of the next entry.
+class InputScript {
+public:
+	InputScript() = default;
+
+	explicit InputScript(const path& script_path) {
+		PTGN_ASSERT(FileExists(script_path), "Input script ", script_path, " could not be found");
+		std::ifstream file{ script_path };
+		json script = json::parse(file);
+
+		for (const auto& entry : script) {
+			Keyframe keyframe;
+			keyframe.time = entry.at("time");
+			for (const auto& key : entry.at("keys")) {
+				SetKey(keyframe.controls, key);
+			}
+			keyframes.push_back(keyframe);
+		}
+
+		std::stable_sort(
+			keyframes.begin(), keyframes.end(),
+			[](const Keyframe& a, const Keyframe& b) { return a.time < b.time; }
+		);
+	}
+
+	// @param time Seconds since the level started.
+	[[nodiscard]] Controls Get(float time) const {
+		Controls controls;
+		for (const auto& keyframe : keyframes) {
+			if (keyframe.time > time) {
+				break;
+			}
+			controls = keyframe.controls;
+		}
+		return controls;
+	}
+
+private:
+	struct Keyframe {
+		float time{ 0.0f };
+		Controls controls;
+	};
+
+	static void SetKey(Controls& controls, const std::string& key) {
+		if (key == "W") {
+			controls.up = true;
+		} else if (key == "S") {
+			controls.down = true;
+		} else if (key == "A") {
+			controls.left = true;
+		} else if (key == "D") {
+			controls.right = true;
+		} else if (key == "Q") {
+			controls.zoom_in = true;
+		} else if (key == "E") {
+			controls.zoom_out = true;
+		} else {
+			PTGN_ERROR("Unrecognized input script key: ", key);
+		}
+	}
+
+	std::vector<Keyframe> keyframes;
+};
+
+enum class LevelOutcome {
+	Running,
+	Won,
+	Lost,
+	TimedOut,
+};
+
+std::string_view ToString(LevelOutcome outcome) {
+	switch (outcome) {
+		case LevelOutcome::Running:	 return "running";
+		case LevelOutcome::Won:		 return "won";
+		case LevelOutcome::Lost:	 return "lost";
+		case LevelOutcome::TimedOut: return "timed out";
+		default:					 PTGN_ERROR("Unrecognized level outcome");
+	}
+}
+
+// Settings for stepping a level at a fixed dt as fast as possible instead of at frame rate.
+struct LevelRunConfig {
+	// Seconds per step.
+	float dt{ 1.0f / 60.0f };
+	// Seconds of game time after which the run is stopped.
+	float max_time{ 120.0f };
+	// Update steps run per engine frame, each frame ends with a single draw.
+	int steps_per_frame{ 8 };
+	InputScript script;
+	// Average milliseconds per step above which the run fails. Zero disables the budget.
+	double budget_ms{ 0.0 };
+	// Disabling this submits world sprites unsorted to measure the draw order the queue replaced.
+	bool sort_draws{ true };
+};
+
+// Wall clock time spent in each system over a level run.
+struct SystemTimings {
+	using Duration = std::chrono::duration<double, std::milli>;
+
+	Duration input{};
+	Duration tornadoes{};
+	Duration physics{};
+	Duration background{};
+	Duration draw{};
+
+	[[nodiscard]] Duration GetUpdateTotal() const {
+		return input + tornadoes + physics + background;
+	}
+};
+
+// Set by the level runner once the run finishes, returned from main.
+int level_runner_exit_code{ 0 };
+
+// Copies of an entity's components which are assigned back in place, so that entity handles
+// captured by tweens and other components remain valid across a restore.
+template <typename... Ts>
+class ComponentSnapshot {
+public:
+	explicit ComponentSnapshot(ecs::Entity entity) :
+		entity{ entity }, components{ entity.Get<Ts>()... } {}
+
+	void Restore() {
+		((entity.Get<Ts>() = std::get<Ts>(components)), ...);
+	}
+
+private:
+	ecs::Entity entity;
+	std::tuple<Ts...> components;
+};
+
+[[nodiscard]] NoiseProperties GetTerrainNoiseProperties() {
+	NoiseProperties properties;
+	properties.octaves	   = 2;
+	properties.frequency   = 0.045f;
+	properties.bias		   = 1.21f;
+	properties.persistence = 0.65f;
+	return properties;
+}
+
+[[nodiscard]] NoiseProperties GetGrassNoiseProperties() {
+	NoiseProperties properties;
+	properties.octaves	   = 6;
+	properties.frequency   = 0.57f;
+	properties.bias		   = 4.4f;
+	properties.persistence = 1.7f;
+	return properties;
+}
+
+// Noise maps covering the whole tile grid of a level which is not streamed.
+struct TerrainMaps {
+	std::vector<float> noise_map;
+	std::vector<float> grass_noise_map;
+};
+
+// Generates on the calling thread only, see the cancellable overload of GenerateFractalNoise.
+// @return Empty maps if stopped was set.
+[[nodiscard]] TerrainMaps GenerateTerrainMaps(
+	std::uint32_t seed, const V2_int& grid_size, const std::atomic<bool>& stopped
+) {
+	ValueNoise noise{ 256, seed };
+	TerrainMaps terrain;
+	terrain.noise_map =
+		GenerateFractalNoise(noise, grid_size, GetTerrainNoiseProperties(), stopped);
+	if (!stopped) {
+		terrain.grass_noise_map =
+			GenerateFractalNoise(noise, grid_size, GetGrassNoiseProperties(), stopped);
+	}
+	return terrain;
+}
+
+[[nodiscard]] V2_int GetLevelGridSize(const level_database::Level& level) {
+	V2_int screen_size{ level.screen_width, level.screen_height };
+	return screen_size * resolution / level_tile_size;
+}
+
 class GameScene : public Scene {
 public:
 	ecs::Manager manager;
 
 	ecs::Entity player;
 
-	const V2_int tile_size{ 16, 16 };
+	const V2_int tile_size{ level_tile_size };
 	V2_int grid_size{ resolution / tile_size };
 
-	std::unordered_set<V2_int> animated_tiles;
-
 	NoiseProperties noise_properties;
-	std::vector<float> noise_map;
 	ValueNoise noise;
 
 	NoiseProperties grass_noise_properties;
-	std::vector<float> grass_noise_map;
 
-	std::unordered_set<V2_int> destroyed_tiles;
+	// Streamed levels only keep the tiles around the camera in memory.
+	bool streaming{ false };
+
+	TileGrid tiles;
+
+	// Reused between frames to avoid reallocating.
+	std::vector<V2_int> evicted_chunks;
+
+	BackgroundChunks background_chunks;
+
+	// Enabled per level for levels with many tornadoes, see UpdateWindField().
+	WindField wind_field;
+
+	// Indexed by TileType, resolved once so that the background draw does not hash tile keys.
+	std::array<Texture, static_cast<std::size_t>(TileType::None)> tile_textures;
 
 	std::vector<ecs::Entity> required_tornadoes;
 
-	json level_data;
+	const level_database::Level* level_data{ nullptr };
 
 	int level{ 0 };
 
-	GameScene(int level) : level{ level } {
+	// Seconds per update step. Hides Scene::dt so that the level runner can step at a fixed dt.
+	float dt{ 0.0f };
+
+	Controls controls;
+
+	// Only set when the level is driven by the level runner.
+	std::shared_ptr<const LevelRunConfig> run_config;
+
+	SystemTimings timings;
+
+	LevelOutcome outcome{ LevelOutcome::Running };
+
+	// Seconds of game time stepped by the level runner.
+	float run_time{ 0.0f };
+	std::size_t steps{ 0 };
+	std::size_t draws{ 0 };
+	DrawQueue::Stats draw_stats;
+	// Frames in which a tornado queued particles, summed over tornadoes.
+	std::size_t particle_system_draws{ 0 };
+
+	// World sprites of the current frame, submitted sorted by layer and texture.
+	DrawQueue draw_queue;
+
+	// Terrain generated ahead of time by the level select, see LevelSelect::PrepareLevel().
+	std::future<TerrainMaps> prepared_terrain;
+
+	GameScene(
+		int level, const std::shared_ptr<const LevelRunConfig>& run_config = nullptr,
+		std::future<TerrainMaps> prepared_terrain = {}
+	) :
+		level{ level }, run_config{ run_config }, prepared_terrain{ std::move(prepared_terrain) } {
 		PTGN_INFO("Starting level: ", level);
+		if (run_config != nullptr) {
+			draw_queue.SetSorted(run_config->sort_draws);
+		}
 	}
 
 	~GameScene() {
@@ -679,13 +1694,91 @@ public:
 		// TODO: Unload tornado textures.
 	}
 
+	using PlayerSnapshot = ComponentSnapshot<
+		Transform, InterpolatedTransform, RigidBody, VehicleComponent, Progress, Size,
+		Aerodynamics>;
+	using TornadoSnapshot = ComponentSnapshot<
+		Texture, Transform, InterpolatedTransform, RigidBody, TornadoComponent, Size>;
+
+	// Level state captured at the end of Init() and restored by RestoreLevel().
+	std::optional<PlayerSnapshot> initial_player;
+	std::vector<TornadoSnapshot> initial_tornadoes;
+	SeededRNG initial_animation_rng;
+	SeededRNG initial_camera_shake_rng;
+
+	// Set by RestartGame(), which may be called from within a tween callback.
+	bool restart_pending{ false };
+
 	void RestartGame() {
-		BackToLevelSelect(level, false);
+		// Level runs end on the outcome instead of returning to the level select.
+		if (run_config != nullptr) {
+			return;
+		}
+
+		restart_pending = true;
+	}
+
+	void CaptureLevel() {
+		initial_player.emplace(player);
+		initial_tornadoes.clear();
+		for (auto [e, tornado] : manager.EntitiesWith<TornadoComponent>()) {
+			initial_tornadoes.emplace_back(e);
+		}
+		initial_animation_rng	 = animation_rng;
+		initial_camera_shake_rng = camera_shake_rng;
+	}
+
+	// Returns the level to its state after Init() without regenerating the tiles or recreating
+	// any entities.
+	void RestoreLevel() {
+		restart_pending = false;
+
+		if (game.tween.Has(Hash("pulled_in_tween"))) {
+			game.tween.Unload(Hash("pulled_in_tween"));
+		}
+
+		if (player.Has<Warning>()) {
+			player.Get<Warning>().Shutdown();
+			player.Remove<Warning>();
+		}
+		if (player.Has<TintColor>()) {
+			player.Remove<TintColor>();
+		}
+		if (player.Has<CameraShake>()) {
+			player.Remove<CameraShake>();
+		}
+
+		PTGN_ASSERT(initial_player.has_value());
+		initial_player->Restore();
+		for (auto& tornado : initial_tornadoes) {
+			tornado.Restore();
+		}
+
+		// Paths are not part of the snapshot since static tornadoes have none.
+		for (auto [e, path] : manager.EntitiesWith<TornadoPath>()) {
+			path.elapsed = 0.0f;
+		}
+
+		// Base tile types never change, so clearing the tile flags restores the grid.
+		tiles.ResetFlags();
+		background_chunks.InvalidateAll();
+		tile_animations.Clear();
+		animation_rng	 = initial_animation_rng;
+		camera_shake_rng = initial_camera_shake_rng;
+		animation_time	 = 0.0f;
+
+		if (game.sound.IsPlaying(3)) {
+			game.sound.Stop(3);
+		}
+		game.sound.Get(Hash("tornado_sound")).SetVolume(min_tornado_volume);
+		game.sound.Get(Hash("tornado_wind_sound")).SetVolume(min_tornado_volume);
+
+		nearest_uncompleted_tornado_entity = ecs::null;
+		camera_shake					   = {};
+		accumulator						   = 0.0f;
+		interpolation					   = 1.0f;
 
-		/*destroyed_tiles.clear();
-		required_tornadoes.clear();
-		manager.Reset();
-		Init();*/
+		manager.Refresh();
 	}
 
 	Rect bounds;
@@ -702,8 +1795,6 @@ public:
 	float zoom{ 1.5f };
 
 	void Init() final {
-		animated_tiles.reserve(100);
-
 		auto& sound = game.sound.Get(Hash("tornado_sound"));
 		game.sound.Stop(1);
 		sound.SetVolume(min_tornado_volume);
@@ -713,17 +1804,14 @@ public:
 		sound_wind.SetVolume(min_tornado_volume);
 		sound_wind.Play(2, -1);
 
-		level_data = json_level_data.at("levels").at(level);
+		const auto& database{ GetLevelDatabase() };
 
-		V2_int screen_size{ level_data.at("screen_size").at(0),
-							level_data.at("screen_size").at(1) };
+		level_data = &database.GetLevel(level);
 
-		grid_size = { screen_size * resolution / tile_size };
+		grid_size = GetLevelGridSize(*level_data);
 
 		PTGN_INFO("Level size: ", grid_size);
 
-		// PTGN_LOG(level_data.dump(4));
-
 		auto primary{ camera.GetPrimary() };
 
 		bounds.pos	  = {};
@@ -733,29 +1821,29 @@ public:
 		primary.SetBounds(bounds);
 		primary.SetZoom(zoom);
 
-		noise_properties.octaves	 = 2;
-		noise_properties.frequency	 = 0.045f;
-		noise_properties.bias		 = 1.21f;
-		noise_properties.persistence = 0.65f;
+		wind_field.Create(bounds.size.x, bounds.size.y, level_data->wind_field_cell_size);
 
-		grass_noise_properties.octaves	   = 6;
-		grass_noise_properties.frequency   = 0.57f;
-		grass_noise_properties.bias		   = 4.4f;
-		grass_noise_properties.persistence = 1.7f;
+		noise_properties	   = GetTerrainNoiseProperties();
+		grass_noise_properties = GetGrassNoiseProperties();
 
-		auto& tornadoes = level_data.at("tornadoes");
+		const auto* tornadoes{ database.GetTornadoes(*level_data) };
 
 		PTGN_ASSERT(
-			!tornadoes.empty(), "Each level must have at least one tornado specified in the JSON"
+			level_data->tornadoes.count > 0,
+			"Each level must have at least one tornado specified in the JSON"
 		);
 
-		std::size_t tornado_id{ 0 };
-		for (const auto& t : tornadoes) {
-			CreateTornado(tornado_id, t);
-			tornado_id++;
+		for (std::size_t tornado_id{ 0 }; tornado_id < level_data->tornadoes.count; tornado_id++) {
+			CreateTornado(tornado_id, tornadoes[tornado_id]);
 		}
 
-		std::uint32_t seed = level_data.at("seed");
+		streaming = level_data->streaming != 0;
+
+		std::uint32_t seed = level_data->seed;
+
+		// Tornado particle generators use the seeds following these, see CreateTornado().
+		animation_rng	 = SeededRNG{ seed, 0.0f, 1.0f };
+		camera_shake_rng = SeededRNG{ seed + 1, 0.0f, two_pi<float> };
 
 		CreateBackground(seed);
 
@@ -766,51 +1854,308 @@ public:
 		);
 
 		manager.Refresh();
+
+		CaptureLevel();
 	}
 
+	const float fixed_dt{ 1.0f / simulation_rate };
+
+	// Frame time which has not been simulated yet.
+	float accumulator{ 0.0f };
+
+	// Frames slower than this many steps drop the remaining time instead of catching up.
+	const int max_steps_per_frame{ 5 };
+
+	// Fraction of a step between the last two simulated states at which entities are drawn.
+	float interpolation{ 1.0f };
+
+	// Suction grows with 1 / distance^2, so steps within this many escape radii of a tornado
+	// are split into up to max_substeps substeps.
+	const float core_substep_ratio{ 4.0f };
+	const int max_substeps{ 8 };
+
 	void Update() final {
+		if (run_config != nullptr) {
+			RunLevel();
+			return;
+		}
+
+		if (restart_pending) {
+			RestoreLevel();
+		}
+
+		controls = Controls::FromKeyboard();
+
 		PTGN_ASSERT(player.Has<Progress>());
 
 		player.Get<Progress>().CheckWinCondition(won);
 
 		if (!won) {
-			PlayerInput();
-
-			UpdateTornadoes();
+			accumulator += std::min(game.dt(), fixed_dt * max_steps_per_frame);
 
-			PlayerPhysics();
+			while (accumulator >= fixed_dt) {
+				Step(fixed_dt);
+				accumulator -= fixed_dt;
+			}
 
-			UpdateBackground();
+			interpolation = accumulator / fixed_dt;
 
-			if (game.input.KeyDown(Key::R)) {
+			if (controls.restart) {
 				RestartGame();
 			}
+
+			// Restarts stay in the level, so leaving it is a separate key.
+			if (controls.exit) {
+				BackToLevelSelect(level, false);
+			}
+		}
+
+		Draw();
+	}
+
+	// Advances the level by step_dt using the current controls. Player forces are integrated in
+	// substeps when the player is close to a tornado core.
+	void Step(float step_dt) {
+		SaveTransforms();
+
+		dt = step_dt;
+
+		int substeps{ GetSubsteps() };
+
+		Timed(timings.input, [&]() { PlayerInput(); });
+		Timed(timings.tornadoes, [&]() { UpdateTornadoes(); });
+
+		V2_float input_acceleration{ player.Get<RigidBody>().acceleration };
+
+		dt = step_dt / static_cast<float>(substeps);
+
+		for (int i{ 0 }; i < substeps; i++) {
+			// PlayerPhysics() consumes the acceleration, so thrust is reapplied every substep.
+			player.Get<RigidBody>().acceleration = input_acceleration;
+			Timed(timings.tornadoes, [&]() { UpdateTornadoGravity(); });
+			Timed(timings.physics, [&]() { PlayerPhysics(); });
+		}
+
+		dt = step_dt;
+
+		if (player.Has<Warning>()) {
+			player.Get<Warning>().Update(dt);
+		}
+
+		Timed(timings.background, [&]() { UpdateBackground(); });
+	}
+
+	[[nodiscard]] int GetSubsteps() {
+		PTGN_ASSERT(player.Has<Transform>());
+		const V2_float& player_pos{ player.Get<Transform>().position };
+
+		int substeps{ 1 };
+
+		for (auto [e, tornado, transform] : manager.EntitiesWith<TornadoComponent, Transform>()) {
+			float ratio{ (transform.position - player_pos).Magnitude() / tornado.escape_radius };
+			if (ratio >= core_substep_ratio) {
+				continue;
+			}
+			float required{ core_substep_ratio / std::max(ratio, 1.0f / max_substeps) };
+			substeps = std::max(substeps, static_cast<int>(std::ceil(required)));
+		}
+
+		return std::min(substeps, max_substeps);
+	}
+
+	void SaveTransforms() {
+		for (auto [e, transform, interpolated] :
+			 manager.EntitiesWith<Transform, InterpolatedTransform>()) {
+			interpolated.previous = transform;
+		}
+	}
+
+	// Replaces each simulated transform with one interpolated between the last two steps for
+	// drawing, RestoreTransforms() must be called after.
+	void InterpolateTransforms() {
+		for (auto [e, transform, interpolated] :
+			 manager.EntitiesWith<Transform, InterpolatedTransform>()) {
+			interpolated.current = transform;
+			transform.position =
+				Lerp(interpolated.previous.position, interpolated.current.position, interpolation);
+			transform.rotation =
+				Lerp(interpolated.previous.rotation, interpolated.current.rotation, interpolation);
+		}
+
+		// Camera follows the drawn player rather than the simulated one.
+		camera.GetPrimary().SetPosition(player.Get<Transform>().position + camera_shake);
+	}
+
+	void RestoreTransforms() {
+		for (auto [e, transform, interpolated] :
+			 manager.EntitiesWith<Transform, InterpolatedTransform>()) {
+			transform = interpolated.current;
+		}
+	}
+
+	template <typename T>
+	static void Timed(SystemTimings::Duration& total, T&& function) {
+		auto start{ std::chrono::steady_clock::now() };
+		function();
+		total += std::chrono::steady_clock::now() - start;
+	}
+
+	// Runs several fixed dt steps per engine frame followed by a single draw, so the level is
+	// simulated as fast as the update allows rather than at the display rate.
+	void RunLevel() {
+		if (outcome != LevelOutcome::Running) {
+			return;
+		}
+
+		PTGN_ASSERT(player.Has<Progress>());
+
+		for (int i{ 0 }; i < run_config->steps_per_frame; i++) {
+			controls = run_config->script.Get(run_time);
+			Step(run_config->dt);
+			run_time += dt;
+			steps++;
+			outcome = GetRunOutcome();
+			if (outcome != LevelOutcome::Running) {
+				break;
+			}
+		}
+
+		Timed(timings.draw, [&]() { Draw(); });
+		draws++;
+
+		if (outcome != LevelOutcome::Running) {
+			FinishRun();
+		}
+	}
+
+	// The win condition is checked directly since Progress::CheckWinCondition waits on a wall
+	// clock timer.
+	[[nodiscard]] LevelOutcome GetRunOutcome() {
+		if (game.tween.Has(Hash("pulled_in_tween"))) {
+			return LevelOutcome::Lost;
+		}
+		if (player.Get<Progress>().CompletedAllRequired()) {
+			return LevelOutcome::Won;
+		}
+		if (run_time >= run_config->max_time) {
+			return LevelOutcome::TimedOut;
+		}
+		return LevelOutcome::Running;
+	}
+
+	void FinishRun() {
+		PTGN_ASSERT(steps > 0);
+		PTGN_ASSERT(draws > 0);
+
+		auto per_step = [&](SystemTimings::Duration duration) {
+			return duration.count() / static_cast<double>(steps);
+		};
+
+		double update_ms{ per_step(timings.GetUpdateTotal()) };
+
+		PTGN_LOG(
+			"Level ", level, " ", ToString(outcome), " after ", run_time, " seconds (", steps,
+			" steps, ", draws, " draws, ", level_data->tornadoes.count, " tornadoes, ",
+			GetJobSystem().GetThreadCount(), " threads)"
+		);
+		// Only depends on the level, the input script and dt, never on timings or thread count.
+		// The benchmark scripts compare it between runs to check that runs are reproducible.
+		const V2_float& player_pos{ player.Get<Transform>().position };
+		PTGN_LOG(
+			"Result: level ", level, " ", ToString(outcome), " after ", steps,
+			" steps, player at ", player_pos.x, ", ", player_pos.y, ", ",
+			player.Get<Progress>().completed_tornadoes.size(), " tornadoes completed"
+		);
+		PTGN_LOG("PlayerInput:     ", per_step(timings.input), " ms/step");
+		PTGN_LOG("UpdateTornadoes: ", per_step(timings.tornadoes), " ms/step");
+		PTGN_LOG("PlayerPhysics:   ", per_step(timings.physics), " ms/step");
+		PTGN_LOG("UpdateBackground:", per_step(timings.background), " ms/step");
+		PTGN_LOG("Update total:    ", update_ms, " ms/step");
+		PTGN_LOG("Draw:            ", timings.draw.count() / static_cast<double>(draws), " ms/draw");
+
+		auto per_draw = [&](std::size_t count) {
+			return static_cast<double>(count) / static_cast<double>(draws);
+		};
+
+		PTGN_LOG(
+			"Draw queue:      ", draw_queue.IsSorted() ? "sorted" : "submission", " order, ",
+			per_draw(draw_stats.submissions), " submissions, ", per_draw(draw_stats.batches),
+			" batches, ", per_draw(draw_stats.sprites), " sprites per draw"
+		);
+		PTGN_LOG(
+			"Renderer:        ", per_draw(draw_stats.renderer.draw_calls), " DrawTexture calls, ",
+			per_draw(draw_stats.renderer.state_changes), " texture or z changes per draw"
+		);
+
+		PTGN_LOG(
+			"Particles:       ", per_draw(particle_system_draws), " particle systems, ",
+			per_draw(draw_stats.groups), " group submissions per draw"
+		);
+
+		// Release builds skip the check in DrawQueue::Flush().
+		if (draw_stats.renderer.draw_calls != draw_stats.sprites) {
+			PTGN_LOG("Renderer received a different number of draws than sprites were queued");
+			level_runner_exit_code = 1;
+		}
+
+		// However many particles a tornado has, it must reach the queue as one submission.
+		if (draw_stats.groups != particle_system_draws) {
+			PTGN_LOG("Particle systems were not queued as exactly one submission each");
+			level_runner_exit_code = 1;
+		}
+
+		if (run_config->budget_ms > 0.0 && update_ms > run_config->budget_ms) {
+			PTGN_LOG("Update exceeded budget of ", run_config->budget_ms, " ms/step");
+			level_runner_exit_code = 1;
+		}
+
+		game.Stop();
+	}
+
+	void FlushDrawQueue() {
+		DrawQueue::Stats stats{ draw_queue.Flush() };
+
+		draw_stats.submissions				+= stats.submissions;
+		draw_stats.groups					+= stats.groups;
+		draw_stats.sprites					+= stats.sprites;
+		draw_stats.batches					+= stats.batches;
+		draw_stats.renderer.draw_calls		+= stats.renderer.draw_calls;
+		draw_stats.renderer.state_changes	+= stats.renderer.state_changes;
+
+		if (log_draw_batches) {
+			PTGN_LOG(
+				"Draw batches: ", stats.batches, ", ", stats.submissions, " submissions, ",
+				stats.sprites, " sprites, ", stats.renderer.draw_calls, " DrawTexture calls, ",
+				stats.renderer.state_changes, " texture or z changes"
+			);
 		}
-
-		Draw();
 	}
 
 	void Draw() {
+		InterpolateTransforms();
+
 		DrawBackground();
 
 		DrawPlayer();
 
 		DrawTornadoes();
 
+		FlushDrawQueue();
+
 		if (!won) {
 			DrawUI();
 		} else {
 			if (!game.tween.Has(Hash("winning_tween"))) {
 				game.tween.Clear();
 
-				std::string icon_path = level_data.at("ui_icon");
+				std::string icon_path{ GetLevelDatabase().GetString(level_data->ui_icon) };
 				std::size_t key{ Hash(icon_path) };
 				PTGN_ASSERT(game.texture.Has(key));
 				Texture t = game.texture.Get(key);
 				constexpr float scale{ 3.0f };
 				PTGN_ASSERT(game.font.Has(Hash("menu_font")));
-				std::string win_text = level_data.at("win_text");
-				Font font			 = game.font.Get(Hash("menu_font"));
+				std::string win_text{ GetLevelDatabase().GetString(level_data->win_text) };
+				Font font = game.font.Get(Hash("menu_font"));
 				Text text{ win_text, color::Silver, font };
 				V2_float text_size = text.GetSize();
 
@@ -890,6 +2235,8 @@ public:
 					.Start();
 			}
 		}
+
+		RestoreTransforms();
 	}
 
 	// Init functions.
@@ -910,6 +2257,10 @@ public:
 		transform.position = pos;
 		transform.rotation = -half_pi<float>;
 
+		auto& interpolated{ entity.Add<InterpolatedTransform>() };
+		interpolated.previous = transform;
+		interpolated.current  = transform;
+
 		auto& rigid_body		= entity.Add<RigidBody>();
 		rigid_body.max_velocity = 225.0f;
 
@@ -930,11 +2281,13 @@ public:
 		return entity;
 	}
 
-	ecs::Entity CreateTornado(std::size_t tornado_id, const json& tornado_data) {
+	ecs::Entity CreateTornado(std::size_t tornado_id, const level_database::Tornado& tornado_data) {
 		ecs::Entity entity = manager.CreateEntity();
 		manager.Refresh();
 
-		std::string tornado_path = tornado_data.at("texture");
+		const auto& database{ GetLevelDatabase() };
+
+		std::string tornado_path{ database.GetString(tornado_data.texture) };
 
 		std::size_t key{ Hash(tornado_path) };
 
@@ -947,71 +2300,55 @@ public:
 
 		auto& texture = entity.Add<Texture>(game.texture.Get(key));
 
-		if (tornado_data.contains("static")) {
-			auto& static_tornado = tornado_data.at("static");
-			auto& tornado_pos	 = static_tornado.at("pos");
+		if (tornado_data.flags & level_database::TornadoFlags::Static) {
 			auto& transform		 = entity.Add<Transform>();
-			transform.position.x = tornado_pos.at(0);
-			transform.position.y = tornado_pos.at(1);
-		} else if (tornado_data.contains("sequence")) {
-			auto& sequence_tornado = tornado_data.at("sequence");
+			transform.position.x = tornado_data.x;
+			transform.position.y = tornado_data.y;
+		} else if (tornado_data.flags & level_database::TornadoFlags::Sequence) {
+			const auto* sequence_tornado{ database.GetSequence(tornado_data) };
+			std::size_t sequence_size{ tornado_data.sequence.count };
 			PTGN_ASSERT(
-				sequence_tornado.size() >= 2,
-				"JSON tornado sequence must contain at least two entries"
+				sequence_size >= 2, "JSON tornado sequence must contain at least two entries"
 			);
-			auto& tornado_pos		  = sequence_tornado.at(0).at("pos");
-			auto& transform			  = entity.Add<Transform>();
-			transform.position.x	  = tornado_pos.at(0);
-			transform.position.y	  = tornado_pos.at(1);
-			std::string sequence_name = "tornado_sequence_" + std::to_string(tornado_id);
-			Tween& sequence			  = game.tween.Load(Hash(sequence_name));
-
-			for (std::size_t current{ 0 }; current < sequence_tornado.size(); current++) {
+			auto& transform		 = entity.Add<Transform>();
+			transform.position.x = tornado_data.x;
+			transform.position.y = tornado_data.y;
+			auto& path			 = entity.Add<TornadoPath>();
+
+			for (std::size_t current{ 0 }; current < sequence_size; current++) {
 				std::size_t next{ current + 1 };
-				if (next >= sequence_tornado.size()) {
+				if (next >= sequence_size) {
 					break;
 				}
 
-				const auto& data_current = sequence_tornado.at(current);
-				const auto& data_next	 = sequence_tornado.at(next);
-
-				V2_float start_pos;
-				V2_float end_pos;
+				const auto& data_current = sequence_tornado[current];
+				const auto& data_next	 = sequence_tornado[next];
 
-				start_pos.x = data_current.at("pos").at(0);
-				start_pos.y = data_current.at("pos").at(1);
+				V2_float start_pos{ data_current.x, data_current.y };
+				V2_float end_pos{ data_next.x, data_next.y };
 
-				end_pos.x = data_next.at("pos").at(0);
-				end_pos.y = data_next.at("pos").at(1);
+				float time_to_next{ static_cast<float>(data_current.time_to_next_ms) / 1000.0f };
 
-				int time_to_next_ms = data_current.at("time_to_next");
-				milliseconds time_to_next{ time_to_next_ms };
+				auto position = [=](float progress) {
+					return Lerp(start_pos, end_pos, progress);
+				};
 
-				sequence.During(time_to_next).OnUpdate([=](float progress) mutable {
-					auto& transform	   = entity.Get<Transform>();
-					transform.position = Lerp(start_pos, end_pos, progress);
-				});
+				path.segments.push_back({ time_to_next, position });
 			}
-			sequence.Start();
 		}
 
-		if (tornado_data.contains("custom1")) {
-			std::string sequence_name = "tornado_sequence_" + std::to_string(tornado_id);
-			Tween& sequence			  = game.tween.Load(Hash(sequence_name));
+		if (tornado_data.flags & level_database::TornadoFlags::Custom1) {
+			// Follows any sequence segments of the same tornado.
+			auto& path{ entity.Has<TornadoPath>() ? entity.Get<TornadoPath>()
+												  : entity.Add<TornadoPath>() };
 
-			const auto& custom_sequence = tornado_data.at("custom1");
-			V2_float rotation_point;
+			V2_float rotation_point{ tornado_data.rotation_x, tornado_data.rotation_y };
 			V2_float end_rotation_point;
-			V2_float end_pos;
+			V2_float end_pos{ tornado_data.end_x, tornado_data.end_y };
 
 			PTGN_ASSERT(entity.Has<Transform>());
 			V2_float start_pos = entity.Get<Transform>().position;
 
-			rotation_point.x = custom_sequence.at("rotation_pos").at(0);
-			rotation_point.y = custom_sequence.at("rotation_pos").at(1);
-			end_pos.x		 = custom_sequence.at("end_pos").at(0);
-			end_pos.y		 = custom_sequence.at("end_pos").at(1);
-
 			end_rotation_point.x = rotation_point.x;
 			end_rotation_point.y = end_pos.y;
 
@@ -1023,39 +2360,40 @@ public:
 
 			PTGN_ASSERT(rotation_distance > 0.0f);
 
-			int rotation_time_ms = custom_sequence.at("rotation_time");
-			milliseconds rotation_time{ rotation_time_ms };
-			int linear_time_ms = custom_sequence.at("linear_time");
-			milliseconds linear_time{ linear_time_ms };
+			int rotation_time_ms{ tornado_data.rotation_time_ms };
+			int linear_time_ms{ tornado_data.linear_time_ms };
+			float linear_time{ static_cast<float>(linear_time_ms) / 1000.0f };
 
 			const float rotation_time_factor =
 				static_cast<float>(rotation_time_ms) / static_cast<float>(linear_time_ms);
 			PTGN_ASSERT(rotation_time_factor > 0.0f);
 
-			sequence.During(linear_time).OnUpdate([=](float progress) mutable {
+			auto position = [=](float progress) {
 				V2_float point = Lerp(rotation_point, end_rotation_point, progress);
 				float angle =
 					Lerp(0.0f, two_pi<float>, std::fmod(progress / rotation_time_factor, 1.0f));
 				float x = point.x + std::cos(angle + starting_angle) * rotation_distance;
 				float y = point.y + std::sin(angle + starting_angle) * rotation_distance;
-				PTGN_ASSERT(entity.Has<Transform>());
-				auto& transform	   = entity.Get<Transform>();
-				transform.position = V2_float{ x, y };
-			});
+				return V2_float{ x, y };
+			};
 
-			sequence.Start();
+			path.segments.push_back({ linear_time, position });
 		}
 
 		PTGN_ASSERT(
 			entity.Has<Transform>(), "Failed to create tornado position from given JSON data"
 		);
 
-		float turn_speed	  = tornado_data.at("turn_speed");
-		float increment_speed = tornado_data.at("increment_speed");
-		float escape_radius	  = tornado_data.at("escape_radius");
-		float data_radius	  = tornado_data.at("data_radius");
-		float gravity_radius  = tornado_data.at("gravity_radius");
-		float warning_radius  = tornado_data.at("warning_radius");
+		auto& interpolated{ entity.Add<InterpolatedTransform>() };
+		interpolated.previous = entity.Get<Transform>();
+		interpolated.current  = entity.Get<Transform>();
+
+		float turn_speed	  = tornado_data.turn_speed;
+		float increment_speed = tornado_data.increment_speed;
+		float escape_radius	  = tornado_data.escape_radius;
+		float data_radius	  = tornado_data.data_radius;
+		float gravity_radius  = tornado_data.gravity_radius;
+		float warning_radius  = tornado_data.warning_radius;
 
 		V2_float texture_size{ texture.GetSize() };
 
@@ -1072,6 +2410,12 @@ public:
 		tornado.gravity_radius	= gravity_radius * width;
 		tornado.warning_radius	= warning_radius * width;
 
+		// The two seeds before these are used by the tile animations and the camera shake.
+		std::uint32_t particle_seed{ level_data->seed + 2 +
+									 static_cast<std::uint32_t>(tornado_id) };
+		tornado.particle_rng =
+			SeededRNG{ particle_seed, -tornado.escape_radius, tornado.escape_radius };
+
 		auto& rigid_body = entity.Add<RigidBody>();
 		// rigid_body.max_velocity = 137.0f;
 
@@ -1085,14 +2429,105 @@ public:
 	}
 
 	void CreateBackground(std::uint32_t seed) {
-		noise			= { 256, seed };
-		noise_map		= FractalNoise::Generate(noise, {}, grid_size, noise_properties);
-		grass_noise_map = FractalNoise::Generate(noise, {}, grid_size, grass_noise_properties);
+		noise = { 256, seed };
+
+		if (streaming) {
+			// Captured by value since chunks are generated on worker threads.
+			tiles.CreateStreamed(
+				grid_size, [noise = noise, noise_properties = noise_properties,
+							grass_noise_properties = grass_noise_properties](const V2_int& chunk) {
+					V2_float offset{ chunk * TileGrid::chunk_size };
+					std::vector<float> noise_map{ FractalNoise::Generate(
+						noise, offset, TileGrid::chunk_size, noise_properties
+					) };
+					std::vector<float> grass_noise_map{ FractalNoise::Generate(
+						noise, offset, TileGrid::chunk_size, grass_noise_properties
+					) };
+					TileGrid::ChunkTiles chunk_tiles;
+					for (std::size_t i{ 0 }; i < chunk_tiles.size(); i++) {
+						chunk_tiles[i] = TileGrid::ClassifyTile(noise_map[i], grass_noise_map[i]);
+					}
+					return chunk_tiles;
+				}
+			);
+		} else if (prepared_terrain.valid()) {
+			// The level select finishes generating the picked level before starting it.
+			TerrainMaps terrain{ prepared_terrain.get() };
+			tiles.Create(grid_size, terrain.noise_map, terrain.grass_noise_map);
+		} else {
+			std::vector<float> noise_map{
+				GenerateFractalNoise(noise, grid_size, noise_properties)
+			};
+			std::vector<float> grass_noise_map{
+				GenerateFractalNoise(noise, grid_size, grass_noise_properties)
+			};
+			tiles.Create(grid_size, noise_map, grass_noise_map);
+		}
+
+		background_chunks.Create(grid_size, tile_size);
+
+		for (std::size_t i{ 0 }; i < tile_textures.size(); i++) {
+			std::size_t key{ GetTileKey(static_cast<TileType>(i)) };
+			PTGN_ASSERT(game.texture.Has(key));
+			tile_textures[i] = game.texture.Get(key);
+		}
 	}
 
 	// Update functions.
 
-	void UpdateBackground() {}
+	void UpdateBackground() {
+		StreamTiles();
+
+		animation_time += dt;
+		tile_animations.Update(animation_time, tiles);
+	}
+
+	void StreamTiles() {
+		if (!tiles.IsStreamed()) {
+			return;
+		}
+
+		V2_int min;
+		V2_int max;
+		GetVisibleTiles(min, max);
+
+		tiles.Stream(min, max, evicted_chunks);
+
+		for (const V2_int& chunk : evicted_chunks) {
+			background_chunks.Evict(chunk);
+		}
+	}
+
+	// Tile range [min, max) covered by the camera, expanded by one tile on each side.
+	void GetVisibleTiles(V2_int& min, V2_int& max) {
+		const auto& primary{ camera.GetPrimary() };
+		Rect camera_rect{ primary.GetRectangle() };
+
+		// Expand size of each tile to include neighbors to prevent edges from flashing
+		// when camera moves.
+
+		min = Clamp(
+			V2_int{ camera_rect.Min() / tile_size } - V2_int{ 1, 1 }, V2_int{ 0, 0 }, grid_size
+		);
+		max = Clamp(
+			V2_int{ camera_rect.Max() / tile_size } + V2_int{ 1, 1 }, V2_int{ 0, 0 }, grid_size
+		);
+	}
+
+	void AnimateTile(const V2_int& tile) {
+		if (tiles.GetBaseType(tile) != TileType::TallGrass) {
+			return;
+		}
+		if (tiles.SetAnimated(tile)) {
+			tile_animations.Start(tile, animation_time);
+		}
+	}
+
+	void DestroyTile(const V2_int& tile) {
+		if (tiles.SetDestroyed(tile)) {
+			background_chunks.Invalidate(tile);
+		}
+	}
 
 	void PlayerInput() {
 		PTGN_ASSERT(player.Has<RigidBody>());
@@ -1103,12 +2538,12 @@ public:
 		auto& vehicle	 = player.Get<VehicleComponent>();
 		auto& transform	 = player.Get<Transform>();
 
-		bool up{ game.input.KeyPressed(Key::W) };
-		bool left{ game.input.KeyPressed(Key::A) };
-		bool down{ game.input.KeyPressed(Key::S) };
-		bool right{ game.input.KeyPressed(Key::D) };
-		bool q{ game.input.KeyPressed(Key::Q) };
-		bool e{ game.input.KeyPressed(Key::E) };
+		bool up{ controls.up };
+		bool left{ controls.left };
+		bool down{ controls.down };
+		bool right{ controls.right };
+		bool q{ controls.zoom_in };
+		bool e{ controls.zoom_out };
 
 		auto& primary{ camera.GetPrimary() };
 
@@ -1142,8 +2577,6 @@ public:
 
 		V2_float thrust;
 
-		bool throttling{ game.tween.Has(Hash("throttle_tween")) };
-
 		auto play_car_sound = [](std::string_view name) {
 			if (!game.sound.IsPlaying(3)) {
 				PTGN_ASSERT(game.sound.Has(Hash(name)));
@@ -1153,52 +2586,25 @@ public:
 			}
 		};
 
+		// The throttle ramps up over throttle_time of simulated time while one direction is held.
 		if ((up || down) && !(up && down)) {
-			if (!throttling) {
-				const auto reset_throttle = [=]() {
-					player.Get<VehicleComponent>().throttle = 0.0f;
-				};
-
-				game.tween.Load(Hash("throttle_tween"))
-					.During(vehicle.throttle_time)
-					.OnUpdate([=](Tween& tween, float f) {
-						PTGN_ASSERT(player.Has<VehicleComponent>());
-						auto& throttle{ player.Get<VehicleComponent>().throttle };
-						// PTGN_LOG("Updating throttle: ", f);
-						bool u{ game.input.KeyPressed(Key::W) };
-						bool d{ game.input.KeyPressed(Key::S) };
-						if (d) {
-							throttle = -f;
-						}
-						if (u) {
-							throttle = f;
-						}
-						if (!u && !d || u && d) {
-							throttle = 0.0f;
-							tween.Reset();
-						}
-					})
-					.OnStop(reset_throttle)
-					.KeepAlive()
-					.Start();
+			if (!vehicle.throttling) {
+				vehicle.throttling		 = true;
+				vehicle.throttle_elapsed = 0.0f;
 				play_car_sound("car_start");
 			} else {
-				auto& throttle = game.tween.Get(Hash("throttle_tween"));
-				if (!throttle.IsStarted() && !throttle.IsCompleted()) {
-					play_car_sound("car_start");
-					throttle.Start();
-				} else {
-					play_car_sound("engine_sound");
-				}
+				vehicle.throttle_elapsed += dt;
+				play_car_sound("engine_sound");
 			}
+			float throttle_time{ std::chrono::duration<float>{ vehicle.throttle_time }.count() };
+			float f{ std::clamp(vehicle.throttle_elapsed / throttle_time, 0.0f, 1.0f) };
+			vehicle.throttle = up ? f : -f;
 		} else {
 			if (game.sound.IsPlaying(3)) {
 				game.sound.Stop(3);
 			}
-			if (throttling) {
-				auto& throttle = game.tween.Get(Hash("throttle_tween"));
-				throttle.Reset();
-			}
+			vehicle.throttling = false;
+			vehicle.throttle   = 0.0f;
 		}
 
 		if (up) {
@@ -1231,7 +2637,7 @@ public:
 		rigid_body.velocity += rigid_body.acceleration * dt;
 
 		// TODO: Fix this.
-		if (game.input.KeyPressed(Key::S)) {
+		if (controls.down) {
 			rigid_body.velocity = Clamp(
 				rigid_body.velocity, -rigid_body.max_velocity * vehicle.backward_thrust_frac,
 				rigid_body.max_velocity * vehicle.backward_thrust_frac
@@ -1257,21 +2663,21 @@ public:
 		// Center camera on player.
 		auto& primary{ camera.GetPrimary() };
 
-		V2_float shake;
+		camera_shake = {};
 
 		if (player.Has<CameraShake>()) {
 			float camera_shake_amplitude{ 1.0f };
-			shake = V2_float::RandomHeading() * camera_shake_amplitude;
+			float heading{ camera_shake_rng() };
+			camera_shake =
+				V2_float{ std::cos(heading), std::sin(heading) } * camera_shake_amplitude;
 		}
 
-		primary.SetPosition(transform.position + shake);
+		primary.SetPosition(transform.position + camera_shake);
 
 		V2_int player_tile = transform.position / tile_size;
 
-		TileType tile_type = GetTileType(GetNoiseValue(player_tile));
-
-		if (tile_type == TileType::Corn) {
-			destroyed_tiles.insert(player_tile);
+		if (tiles.GetBaseType(player_tile) == TileType::Corn) {
+			DestroyTile(player_tile);
 		}
 
 		rigid_body.acceleration = {};
@@ -1302,6 +2708,8 @@ public:
 
 	ecs::Entity nearest_uncompleted_tornado_entity = ecs::null;
 
+	V2_float camera_shake;
+
 	int won = 0;
 
 	void UpdateTornadoGravity() {
@@ -1318,7 +2726,6 @@ public:
 
 		float player_max_thrust{ player_vehicle.thrust };
 
-		auto& player_rigid_body{ player.Get<RigidBody>() };
 		const auto& player_aero{ player.Get<Aerodynamics>() };
 
 		bool within_danger{ false };
@@ -1345,14 +2752,14 @@ public:
 				continue;
 			}
 
-			V2_float wind_speed{ tornado.GetWind(dir, player_aero.pull_resistance) * dt };
-
 			// Apply tornado effects to player.
 
-			player_rigid_body.velocity	   += wind_speed;
-			player_transform.rotation	   += wind_speed.Magnitude() / player_vehicle.inertia;
-			player_rigid_body.acceleration += tornado.GetSuction(dir, player_max_thrust);
-			player_rigid_body.velocity	   += rigid_body.velocity * dt;
+			if (!wind_field.IsEnabled()) {
+				ApplyTornadoForces(
+					tornado.GetWind(dir, player_aero.pull_resistance),
+					tornado.GetSuction(dir, player_max_thrust), rigid_body.velocity
+				);
+			}
 
 			if (!game.collision.overlap.PointCircle(
 					player_transform.position, { transform.position, tornado.data_radius }
@@ -1400,15 +2807,25 @@ public:
 				.Start();
 		}
 
+		if (wind_field.IsEnabled()) {
+			const V2_float& pos{ player_transform.position };
+			WindSample sample{ wind_field.Sample(pos.x, pos.y) };
+			ApplyTornadoForces(
+				V2_float{ sample.wind_x, sample.wind_y } / player_aero.pull_resistance,
+				V2_float{ sample.suction_x, sample.suction_y } * player_max_thrust,
+				V2_float{ sample.velocity_x, sample.velocity_y }
+			);
+		}
+
 		if (data_tornadoes.size() > 0) {
 			auto closest_tornado = GetClosestTornado(data_tornadoes);
-			player.Get<Progress>().Update(closest_tornado, player_transform.position);
+			player.Get<Progress>().Update(closest_tornado, player_transform.position, dt);
 		} else {
 			auto& sound = game.sound.Get(Hash("tornado_sound"));
 			sound.SetVolume(min_tornado_volume);
 			auto& sound_wind = game.sound.Get(Hash("tornado_wind_sound"));
 			sound_wind.SetVolume(min_tornado_volume);
-			player.Get<Progress>().DecrementTornadoProgress();
+			player.Get<Progress>().DecrementTornadoProgress(dt);
 		}
 
 		if (within_danger) {
@@ -1423,96 +2840,222 @@ public:
 		}
 	}
 
+	void ApplyTornadoForces(
+		const V2_float& wind, const V2_float& suction, const V2_float& tornado_velocity
+	) {
+		auto& player_transform{ player.Get<Transform>() };
+		auto& player_rigid_body{ player.Get<RigidBody>() };
+		float inertia{ player.Get<VehicleComponent>().inertia };
+
+		V2_float wind_speed{ wind * dt };
+
+		player_rigid_body.velocity	   += wind_speed;
+		player_transform.rotation	   += wind_speed.Magnitude() / inertia;
+		player_rigid_body.acceleration += suction;
+		player_rigid_body.velocity	   += tornado_velocity * dt;
+	}
+
+	// UpdateTornadoGravity() is run separately since it is substepped with the player physics.
 	void UpdateTornadoes() {
 		TornadoMotion();
-		UpdateTornadoGravity();
+		UpdateWindField();
+		UpdateTornadoParticles();
+	}
+
+	// Rebuilds the wind field from every tornado after they moved, so that the player, debris
+	// and grass pay a constant cost per sample regardless of the tornado count.
+	void UpdateWindField() {
+		if (!wind_field.IsEnabled()) {
+			return;
+		}
+
+		wind_field.Clear();
+
+		for (auto [e, tornado, transform, rigid_body] :
+			 manager.EntitiesWith<TornadoComponent, Transform, RigidBody>()) {
+			wind_field.Add(tornado.GetWindSource(transform.position, rigid_body.velocity));
+		}
+
+		AnimateWindField();
+	}
+
+	// Each tornado only writes to its own particles.
+	void UpdateTornadoParticles() {
+		Rect view{ camera.GetPrimary().GetRectangle() };
+		GetJobSystem().ParallelFor(tornado_entities.size(), [&](std::size_t i) {
+			ecs::Entity e{ tornado_entities[i] };
+			e.Get<TornadoComponent>().UpdateParticles(e, dt, wind_field, view);
+		});
 	}
 
-	RNG<float> animation_rng{ 0.0f, 1.0f };
+	// Seeded from the level in Init(), so that runs of a level animate the same tiles.
+	SeededRNG animation_rng;
+	// Camera shake heading in radians.
+	SeededRNG camera_shake_rng;
 	float tall_grass_animation_probability{ 0.1f };
 
+	void DestroySpans(const std::vector<TileSpan>& spans) {
+		for (const TileSpan& span : spans) {
+			for (int i{ span.x_min }; i <= span.x_max; i++) {
+				V2_int tile{ i, span.y };
+				if (draw_hitboxes) {
+					game.renderer.DrawRectangleFilled(
+						Rect{ tile * tile_size, tile_size, Origin::TopLeft }, color::Purple
+					);
+				}
+				DestroyTile(tile);
+			}
+		}
+	}
+
+	// Number of tiles skipped before the next animated tile.
+	// @param log_miss Logarithm of the probability that a tile is not animated.
+	std::int64_t GetAnimationGap(float log_miss) {
+		float p{ std::max(animation_rng(), std::numeric_limits<float>::min()) };
+		return static_cast<std::int64_t>(std::log(p) / log_miss);
+	}
+
+	// Each tile is animated with tall_grass_animation_probability. Rather than rolling once per
+	// tile, the gap until the next animated tile is drawn from the matching geometric
+	// distribution, so only animated tiles cost a random number.
+	void AnimateSpans(const std::vector<TileSpan>& spans) {
+		PTGN_ASSERT(tall_grass_animation_probability > 0.0f);
+		if (tall_grass_animation_probability >= 1.0f) {
+			for (const TileSpan& span : spans) {
+				for (int i{ span.x_min }; i <= span.x_max; i++) {
+					AnimateTile({ i, span.y });
+				}
+			}
+			return;
+		}
+
+		const float log_miss{ std::log(1.0f - tall_grass_animation_probability) };
+
+		auto next_gap = [&]() {
+			return GetAnimationGap(log_miss);
+		};
+
+		std::int64_t gap{ next_gap() };
+
+		for (const TileSpan& span : spans) {
+			std::int64_t width{ span.x_max - span.x_min + 1 };
+			std::int64_t offset{ gap };
+			while (offset < width) {
+				AnimateTile({ span.x_min + static_cast<int>(offset), span.y });
+				offset += 1 + next_gap();
+			}
+			gap = offset - width;
+		}
+	}
+
+	// Animates visible tall grass with the same odds as AnimateSpans() gives a tile covered by
+	// the gravity radius of the sampled number of tornadoes. Tiles are processed in segments of
+	// one field cell which share a single sample.
+	void AnimateWindField() {
+		PTGN_ASSERT(tall_grass_animation_probability > 0.0f);
+
+		V2_int min;
+		V2_int max;
+		GetVisibleTiles(min, max);
+
+		const float log_miss{ std::log(1.0f - tall_grass_animation_probability) };
+		const int segment{ std::max(1, static_cast<int>(wind_field.GetCellSize()) / tile_size.x) };
+
+		for (int y{ min.y }; y < max.y; y++) {
+			for (int x{ min.x }; x < max.x; x += segment) {
+				int x_max{ std::min(x + segment, max.x) - 1 };
+				V2_float center{ V2_float{ (x + x_max + 1) * 0.5f, y + 0.5f } * tile_size };
+				float coverage{ wind_field.Sample(center.x, center.y).coverage };
+				if (coverage <= 0.0f) {
+					continue;
+				}
+				// Not being animated by any of the covering tornadoes.
+				float segment_log_miss{ coverage * log_miss };
+				for (std::int64_t offset{ GetAnimationGap(segment_log_miss) }; offset <= x_max - x;
+					 offset += 1 + GetAnimationGap(segment_log_miss)) {
+					AnimateTile({ x + static_cast<int>(offset), y });
+				}
+			}
+		}
+	}
+
+	// Tornadoes updated by the job system, gathered once per step.
+	std::vector<ecs::Entity> tornado_entities;
+
+	// Tiles marked by each tornado's job. The tile grid, animations and animation RNG are
+	// shared, so the marks are applied in tornado order once every job has finished.
+	struct TileMarks {
+		std::vector<TileSpan> destroyed;
+		std::vector<TileSpan> animated;
+	};
+
+	std::vector<TileMarks> tornado_tile_marks;
+
 	void TornadoMotion() {
-		auto tornadoes = manager.EntitiesWith<TornadoComponent, Transform, RigidBody>();
+		tornado_entities.clear();
+		for (auto [e, tornado] : manager.EntitiesWith<TornadoComponent, Transform, RigidBody>()) {
+			tornado_entities.push_back(e);
+		}
+		tornado_tile_marks.resize(tornado_entities.size());
 
 		const float tornado_move_speed{ 1000.0f };
 
-		animated_tiles.clear();
+		for (auto [e, path, transform] : manager.EntitiesWith<TornadoPath, Transform>()) {
+			transform.position = path.Advance(dt);
+		}
 
-		for (auto [e, tornado, transform, rigid_body] : tornadoes) {
-			// TODO: Remove
+		// TODO: Remove
+		V2_float debug_velocity;
+		// Level runs only take input from their script.
+		if (run_config == nullptr) {
 			if (game.input.KeyDown(Key::LEFT)) {
-				rigid_body.velocity.x -= tornado_move_speed * dt;
+				debug_velocity.x -= tornado_move_speed * dt;
 			} else if (game.input.KeyDown(Key::RIGHT)) {
-				rigid_body.velocity.x += tornado_move_speed * dt;
+				debug_velocity.x += tornado_move_speed * dt;
 			}
 			if (game.input.KeyDown(Key::UP)) {
-				rigid_body.velocity.y -= tornado_move_speed * dt;
+				debug_velocity.y -= tornado_move_speed * dt;
 			} else if (game.input.KeyDown(Key::DOWN)) {
-				rigid_body.velocity.y += tornado_move_speed * dt;
+				debug_velocity.y += tornado_move_speed * dt;
 			}
+		}
+
+		GetJobSystem().ParallelFor(tornado_entities.size(), [&](std::size_t i) {
+			ecs::Entity e{ tornado_entities[i] };
+			auto& tornado{ e.Get<TornadoComponent>() };
+			auto& transform{ e.Get<Transform>() };
+			auto& rigid_body{ e.Get<RigidBody>() };
+			TileMarks& marks{ tornado_tile_marks[i] };
+
+			rigid_body.velocity += debug_velocity;
 
 			rigid_body.velocity =
 				Clamp(rigid_body.velocity, -rigid_body.max_velocity, rigid_body.max_velocity);
 
 			transform.position += rigid_body.velocity * dt;
 
-			V2_int min_gravity{ (transform.position -
-								 V2_float{ tornado.gravity_radius, tornado.gravity_radius }) /
-								tile_size };
-			V2_int max_gravity{ (transform.position +
-								 V2_float{ tornado.gravity_radius, tornado.gravity_radius }) /
-								tile_size };
-
-			V2_int min_escape{ (transform.position -
-								V2_float{ tornado.escape_radius, tornado.escape_radius }) /
-							   tile_size };
-			V2_int max_escape{ (transform.position +
-								V2_float{ tornado.escape_radius, tornado.escape_radius }) /
-							   tile_size };
-
-			Circle tornado_destruction{ transform.position, tornado.escape_radius };
-			Circle tornado_gravity{ transform.position, tornado.gravity_radius };
-
-			PTGN_ASSERT(min_gravity.x <= max_gravity.x);
-			PTGN_ASSERT(min_gravity.y <= max_gravity.y);
-			PTGN_ASSERT(min_escape.x <= max_escape.x);
-			PTGN_ASSERT(min_escape.y <= max_escape.y);
-
 			// Destroy all tiles within escape radius of tornado
-			for (int i = min_escape.x; i <= max_escape.x; i++) {
-				for (int j = min_escape.y; j <= max_escape.y; j++) {
-					V2_int tile{ i, j };
-					Rect tile_rect{ tile * tile_size, tile_size, Origin::TopLeft };
-					// auto tile_type = GetTileType(GetNoiseValue(tile));
-					if (game.collision.overlap.CircleRectangle(tornado_destruction, tile_rect)) {
-						if (draw_hitboxes) {
-							game.renderer.DrawRectangleFilled(tile_rect, color::Purple);
-						}
-						destroyed_tiles.insert(tile);
-					}
-				}
-			}
+			RasterizeCircle(
+				transform.position, tornado.escape_radius, tile_size, grid_size, marks.destroyed
+			);
 
-			// Animate random tiles within tornado radius.
-			for (int i = min_gravity.x; i <= max_gravity.x; i++) {
-				for (int j = min_gravity.y; j <= max_gravity.y; j++) {
-					V2_int tile{ i, j };
-					Rect tile_rect{ tile * tile_size, tile_size, Origin::TopLeft };
-					// auto tile_type = GetTileType(GetNoiseValue(tile));
-					if (game.collision.overlap.CircleRectangle(tornado_gravity, tile_rect)) {
-						// game.renderer.DrawRectangleFilled(tile_rect, color::Purple, 0.0f,
-						// {}, 40.0f);
-						float p{ animation_rng() };
-						if (p <= tall_grass_animation_probability) {
-							animated_tiles.insert(tile);
-						}
-					}
-				}
+			// Animate random tiles within tornado radius. With a wind field the grass is
+			// animated from the field instead, see AnimateWindField().
+			if (!wind_field.IsEnabled()) {
+				RasterizeCircle(
+					transform.position, tornado.gravity_radius, tile_size, grid_size,
+					marks.animated
+				);
 			}
 
 			transform.rotation += tornado.turn_speed * dt;
+		});
 
-			tornado.UpdateParticles(e);
+		for (const TileMarks& marks : tornado_tile_marks) {
+			DestroySpans(marks.destroyed);
+			if (!wind_field.IsEnabled()) {
+				AnimateSpans(marks.animated);
+			}
 		}
 	}
 
@@ -1532,26 +3075,27 @@ public:
 		V2_float relative_wheel_pos =
 			V2_float{ (25 - 15), 0.0f }.Rotated(player_transform.rotation);
 
-		game.renderer.DrawTexture(
+		draw_queue.Add(
 			vehicle.wheel_texture, player_transform.position + relative_wheel_pos,
 			vehicle.wheel_texture.GetSize(), {}, {}, Origin::Center, Flip::None,
-			player_transform.rotation + vehicle.wheel_rotation, { 0.5f, 0.5f }, 1.0f, tint
+			player_transform.rotation + vehicle.wheel_rotation, { 0.5f, 0.5f }, 1, tint
 		);
 
-		game.renderer.DrawTexture(
+		draw_queue.Add(
 			vehicle.texture, player_transform.position, size, {}, {}, Origin::Center, Flip::None,
-			player_transform.rotation, { 0.5f, 0.5f }, 2.0f, tint
-
+			player_transform.rotation, { 0.5f, 0.5f }, 2, tint
 		);
 	}
 
 	void DrawTornadoes() {
 		auto tornadoes = manager.EntitiesWith<TornadoComponent, Texture, Transform, Size>();
 
+		Rect view{ camera.GetPrimary().GetRectangle() };
+
 		for (auto [e, tornado, texture, transform, size] : tornadoes) {
-			game.renderer.DrawTexture(
+			draw_queue.Add(
 				texture, transform.position, size, {}, {}, Origin::Center, Flip::None,
-				transform.rotation, { 0.5f, 0.5f }, 2.0f, tornado.tint
+				transform.rotation, { 0.5f, 0.5f }, 2, tornado.tint
 			);
 
 			if (draw_hitboxes) {
@@ -1569,122 +3113,56 @@ public:
 				);
 			}
 
-			tornado.DrawParticles();
-		}
-	}
-
-	float GetNoiseValue(const V2_int& tile) {
-		int index{ tile.x + grid_size.x * tile.y };
-		if (index >= noise_map.size() || index < 0) {
-			return -1.0f;
-		}
-		float noise_value{ noise_map[index] };
-		PTGN_ASSERT(noise_value >= 0.0f);
-		PTGN_ASSERT(noise_value <= 1.0f);
-		return noise_value;
-	}
-
-	float GetGrassNoiseValue(const V2_int& tile) {
-		int index{ tile.x + grid_size.x * tile.y };
-		if (index >= grass_noise_map.size() || index < 0) {
-			return -1.0f;
+			if (tornado.DrawParticles(draw_queue, view)) {
+				particle_system_draws++;
+			}
 		}
-		float noise_value{ grass_noise_map[index] };
-		PTGN_ASSERT(noise_value >= 0.0f);
-		PTGN_ASSERT(noise_value <= 1.0f);
-		return noise_value;
 	}
 
 	milliseconds tall_grass_animation_duration{ 300 };
 	const int tall_grass_animation_columns{ 4 };
 
-	void DrawBackground() {
-		const auto& primary{ camera.GetPrimary() };
-		Rect camera_rect{ primary.GetRectangle() };
-
-		// game.renderer.DrawRectangleHollow(camera_rect, color::Blue, 3.0f);
-
-		Rect tile_rect{ {}, tile_size, Origin::TopLeft };
-
-		// Expand size of each tile to include neighbors to prevent edges from flashing
-		// when camera moves. Skip grid tiles not within camera view.
-
-		V2_int min{ Clamp(
-			V2_int{ camera_rect.Min() / tile_size } - V2_int{ 1, 1 }, V2_int{ 0, 0 }, grid_size
-		) };
-		V2_int max{ Clamp(
-			V2_int{ camera_rect.Max() / tile_size } + V2_int{ 1, 1 }, V2_int{ 0, 0 }, grid_size
-		) };
+	// Seconds of unpaused game time, used as the clock for tile animations.
+	float animation_time{ 0.0f };
 
-		for (int i{ min.x }; i < max.x; i++) {
-			for (int j{ min.y }; j < max.y; j++) {
-				V2_int tile{ i, j };
+	TileAnimations tile_animations{
+		std::chrono::duration<float>(tall_grass_animation_duration).count(),
+		tall_grass_animation_columns
+	};
 
-				tile_rect.pos = tile * tile_size;
-
-				float noise_value{ GetNoiseValue(tile) };
-
-				PTGN_ASSERT(noise_value >= 0.0f);
-
-				bool destroyed_tile{ destroyed_tiles.count(tile) > 0 };
+	void DrawBackground() {
+		// Skip grid tiles not within camera view.
+		V2_int min;
+		V2_int max;
+		GetVisibleTiles(min, max);
 
-				TileType tile_type = GetTileType(noise_value);
+		std::size_t draw_calls{ background_chunks.Draw(draw_queue, min, max, tiles, tile_textures) };
 
-				auto size = tile_rect.size;
-				float z_index{ 0.0f };
+		const Texture& tall_grass{ tile_textures[static_cast<std::size_t>(TileType::TallGrass)] };
 
-				if (tile_type == TileType::House) {
-					// size	= tile_rect.size * 3;
-					z_index = 1.0f;
-				}
+		// Animated tall grass is drawn on top of the baked chunks.
+		for (const auto& animation : tile_animations.GetAnimations()) {
+			const V2_int& tile{ animation.tile };
 
-				if (destroyed_tile) {
-					if (tile_type == TileType::House) {
-						tile_type = TileType::HouseDestroyed;
-					} else {
-						tile_type = TileType::Dirt;
-					}
-				}
+			if (tile.x < min.x || tile.y < min.y || tile.x >= max.x || tile.y >= max.y) {
+				continue;
+			}
 
-				if (tile_type == TileType::Grass) {
-					float grass_noise_value{ GetGrassNoiseValue(tile) };
-					if (grass_noise_value >= 0.65f) {
-						tile_type = TileType::TallGrass;
-					}
-				}
+			// Tile may have been destroyed since the animation started.
+			if (tiles.GetType(tile) != TileType::TallGrass) {
+				continue;
+			}
 
-				Texture t = game.texture.Get(GetTileKey(tile_type));
+			draw_queue.Add(
+				tall_grass, tile * tile_size, tile_size,
+				V2_int{ animation.column * tile_size.x, 0 }, tile_size, Origin::TopLeft, Flip::None,
+				0.0f, { 0.5f, 0.5f }, 1
+			);
+			draw_calls++;
+		}
 
-				if (tile_type == TileType::TallGrass) {
-					bool animated_tile{ animated_tiles.count(tile) > 0 };
-					if (animated_tile) {
-						game.tween.Load(Hash(tile))
-							.During(tall_grass_animation_duration)
-							.Yoyo()
-							.OnUpdate([=](float f) {
-								auto column = static_cast<int>(
-									f * static_cast<float>(tall_grass_animation_columns - 1)
-								);
-								game.renderer.DrawTexture(
-									t, tile_rect.pos, size, V2_int{ column * tile_size.x, 0 },
-									tile_size, Origin::TopLeft, Flip::None, 0.0f, { 0.5f, 0.5f },
-									1.0f
-								);
-							})
-							.Start();
-					}
-					int column = 0;
-					game.renderer.DrawTexture(
-						t, tile_rect.pos, size, V2_int{ column, 0 }, tile_size, Origin::TopLeft,
-						Flip::None, 0.0f, { 0.5f, 0.5f }, z_index
-					);
-				} else {
-					game.renderer.DrawTexture(
-						t, tile_rect.pos, size, {}, {}, Origin::TopLeft, Flip::None, 0.0f,
-						{ 0.5f, 0.5f }, z_index
-					);
-				}
-			}
+		if (log_background_draw_calls) {
+			PTGN_LOG("Background sprites queued: ", draw_calls);
 		}
 	}
 
@@ -1916,25 +3394,18 @@ public:
 
 	std::set<int> completed_levels;
 
-	json level_data;
-
 	bool CompletedLevel(int level) const {
 		return completed_levels.count(level) > 0;
 	}
 
-	json GetLevel(int level) const {
-		for (const auto& l : level_data.at("levels")) {
-			if (l.at("id") == level) {
-				return l;
-			}
-		}
-		PTGN_ERROR("Failed to find level in json");
+	const level_database::Level& GetLevel(int level) const {
+		PTGN_ASSERT(GetLevelDatabase().HasLevel(level), "Failed to find level in database");
+		return GetLevelDatabase().GetLevel(level);
 	}
 
 	std::string GetDetails(int level) const {
 		PTGN_ASSERT(level != -1);
-		auto l = GetLevel(level);
-		return l.at("details");
+		return std::string{ GetLevelDatabase().GetString(GetLevel(level).details) };
 	}
 
 	void Preload() {
@@ -1962,9 +3433,108 @@ public:
 		}
 	}
 
+	// Terrain of a level currently offered, generated while the player chooses.
+	struct PreparedLevel {
+		std::future<TerrainMaps> terrain;
+		// Shared with the generating thread, which checks it between noise bands.
+		std::shared_ptr<std::atomic<bool>> stopped{ std::make_shared<std::atomic<bool>>(false) };
+		// Generates on a single core.
+		std::thread thread;
+
+		PreparedLevel()								   = default;
+		PreparedLevel(const PreparedLevel&)			   = delete;
+		PreparedLevel& operator=(const PreparedLevel&) = delete;
+		PreparedLevel(PreparedLevel&&) noexcept		   = default;
+
+		PreparedLevel& operator=(PreparedLevel&& other) noexcept {
+			if (this != &other) {
+				Stop();
+				Join();
+				terrain = std::move(other.terrain);
+				stopped = std::move(other.stopped);
+				thread	= std::move(other.thread);
+			}
+			return *this;
+		}
+
+		// Abandoned levels never leave a running or unjoined thread behind.
+		~PreparedLevel() {
+			Stop();
+			Join();
+		}
+
+		void Stop() {
+			if (stopped != nullptr) {
+				*stopped = true;
+			}
+		}
+
+		void Join() {
+			if (thread.joinable()) {
+				thread.join();
+			}
+		}
+	};
+
+	std::unordered_map<int, PreparedLevel> prepared_levels;
+
+	// Loads the tornado textures of a level which may be picked next and starts generating its
+	// terrain on a thread owned by the level select. Textures are loaded here since they cannot
+	// be created off the main thread.
+	void PrepareLevel(int level) {
+		const auto& database{ GetLevelDatabase() };
+		const auto& level_data{ GetLevel(level) };
+
+		const auto* tornadoes{ database.GetTornadoes(level_data) };
+		for (std::size_t i{ 0 }; i < level_data.tornadoes.count; i++) {
+			std::string tornado_path{ database.GetString(tornadoes[i].texture) };
+			std::size_t key{ Hash(tornado_path) };
+			if (!game.texture.Has(key) && FileExists(tornado_path)) {
+				game.texture.Load(key, tornado_path);
+			}
+		}
+
+#ifndef __EMSCRIPTEN__
+		// Streamed levels generate their chunks on demand instead.
+		if (level_data.streaming != 0 || prepared_levels.count(level) > 0) {
+			return;
+		}
+		PreparedLevel& prepared{ prepared_levels[level] };
+		std::packaged_task<TerrainMaps()> task{
+			[seed = level_data.seed, grid_size = GetLevelGridSize(level_data),
+			 stopped = prepared.stopped]() {
+				return GenerateTerrainMaps(seed, grid_size, *stopped);
+			}
+		};
+		prepared.terrain = task.get_future();
+		prepared.thread	 = std::thread{ std::move(task) };
+#endif
+	}
+
+	// Stops generating the terrain of every offered level except keep_level, which is waited on
+	// instead. No preparation thread outlives the level select.
+	// @return Terrain of keep_level if it was being prepared.
+	std::future<TerrainMaps> CancelPreparedLevels(int keep_level = -1) {
+		std::future<TerrainMaps> kept;
+		for (auto& [l, prepared] : prepared_levels) {
+			if (l != keep_level) {
+				prepared.Stop();
+			}
+		}
+		if (auto it{ prepared_levels.find(keep_level) }; it != prepared_levels.end()) {
+			it->second.Join();
+			kept = std::move(it->second.terrain);
+		}
+		// Joins the stopped threads, each finishes at most one more noise band.
+		prepared_levels.clear();
+		return kept;
+	}
+
 	void StartGame(int level) {
+		std::future<TerrainMaps> prepared_terrain{ CancelPreparedLevels(level) };
+
 		game.scene.RemoveActive(Hash("level_select"));
-		game.scene.Load<GameScene>(Hash("game"), level);
+		game.scene.Load<GameScene>(Hash("game"), level, nullptr, std::move(prepared_terrain));
 		game.scene.AddActive(Hash("game"));
 	}
 
@@ -1983,9 +3553,8 @@ public:
 	void CreateLevelButton(int level) {
 		Rectangle rect;
 
-		auto l				  = GetLevel(level);
-		std::string icon_name = l.at("ui_icon");
-		std::size_t key		  = Hash(icon_name);
+		std::string icon_name{ GetLevelDatabase().GetString(GetLevel(level).ui_icon) };
+		std::size_t key = Hash(icon_name);
 
 		PTGN_ASSERT(game.texture.Has(key));
 
@@ -2046,11 +3615,14 @@ public:
 	std::set<int> GetPotentialLevels() {
 		std::set<int> potential_levels;
 
-		for (auto& b : level_data.at("branches")) {
-			if (difficulty_layer >= b.size()) {
+		const auto& database{ GetLevelDatabase() };
+
+		for (std::size_t i = 0; i < database.GetBranchCount(); i++) {
+			const auto& b{ database.GetBranch(i) };
+			if (difficulty_layer >= b.count) {
 				continue;
 			}
-			int potential_level = b[difficulty_layer];
+			int potential_level = database.GetBranchLevel(b, difficulty_layer);
 			if (CompletedLevel(potential_level)) {
 				continue;
 			}
@@ -2089,24 +3661,25 @@ public:
 	void Init() final {
 		text_rect = { V2_int{ 1223, 98 }, button_size, Origin::Center };
 
-		level_data = json_level_data;
+		const auto& database{ GetLevelDatabase() };
 
 		std::size_t furthest_branch = 0;
 
-		for (const auto& b : level_data.at("branches")) {
-			for (std::size_t i = 0; i < b.size(); i++) {
-				furthest_branch = std::max(i, furthest_branch);
+		for (std::size_t i = 0; i < database.GetBranchCount(); i++) {
+			const auto& b{ database.GetBranch(i) };
+			if (b.count > 0) {
+				furthest_branch = std::max(std::size_t{ b.count } - 1, furthest_branch);
 			}
 		}
 
-		auto& difficulties = level_data.at("difficulty_layers");
+		std::size_t difficulty_count{ database.GetDifficultyLayerCount() };
 
-		PTGN_ASSERT(difficulties.size() >= furthest_branch + 1);
+		PTGN_ASSERT(difficulty_count >= furthest_branch + 1);
 
-		PTGN_ASSERT(!difficulties.empty());
+		PTGN_ASSERT(difficulty_count > 0);
 
 		if (!game.music.IsPlaying()) {
-			std::string music_path = difficulties.at(0).at("music");
+			std::string music_path{ database.GetString(database.GetDifficultyLayer(0).music) };
 			std::size_t music_key  = Hash(music_path);
 			playing_music_key	   = music_key;
 			if (!game.music.Has(music_key)) {
@@ -2115,15 +3688,15 @@ public:
 			PlayMusic(music_key);
 		}
 
-		for (int l : level_data.at("completed_levels")) {
-			completed_levels.emplace(l);
+		for (std::size_t i = 0; i < database.GetCompletedLevelCount(); i++) {
+			completed_levels.emplace(database.GetCompletedLevel(i));
 		}
 
-		for (const auto& l : level_data.at("levels")) {
-			std::string icon_path = l.at("ui_icon");
+		for (int l = 0; l < static_cast<int>(database.GetLevelCount()); l++) {
+			std::string icon_path{ database.GetString(database.GetLevel(l).ui_icon) };
 			std::size_t key{ Hash(icon_path) };
 			if (!game.texture.Has(key)) {
-				PTGN_ASSERT(FileExists(icon_path), "Could not find icon for level: ", l.at("id"));
+				PTGN_ASSERT(FileExists(icon_path), "Could not find icon for level: ", l);
 				game.texture.Load(key, icon_path);
 			}
 		}
@@ -2143,11 +3716,12 @@ public:
 
 			for (int l : potential_levels) {
 				CreateLevelButton(l);
+				PrepareLevel(l);
 			}
 		}
 
 		PTGN_ASSERT(
-			difficulty_layer < difficulties.size(),
+			difficulty_layer < difficulty_count,
 			"Difficulty layer exceeded those specified in JSON"
 		);
 
@@ -2161,7 +3735,9 @@ public:
 			select_bg = game.texture.Get(Hash("level_select_bg0"));
 		}
 
-		std::string music_path = difficulties.at(difficulty_layer).at("music");
+		std::string music_path{
+			database.GetString(database.GetDifficultyLayer(difficulty_layer).music)
+		};
 		std::size_t music_key  = Hash(music_path);
 
 		if (playing_music_key != music_key) {
@@ -2235,6 +3811,7 @@ public:
 			buttons.push_back(CreateMenuButton(
 				"Back", color::Silver,
 				[&]() {
+					CancelPreparedLevels();
 					game.scene.RemoveActive(Hash("level_select"));
 					if (!game.scene.Has(Hash("main_menu"))) {
 						LoadMainMenu();
@@ -2347,32 +3924,37 @@ public:
 	}
 };
 
+// Resources used by the GameScene.
+void LoadGameResources() {
+	game.texture.Load(Hash("tutorial_text"), "resources/ui/instructions.png");
+	game.texture.Load(Hash("grass"), "resources/entity/grass.png");
+	game.texture.Load(Hash("tall_grass"), "resources/entity/tall_grass.png");
+	game.texture.Load(Hash("dirt"), "resources/entity/dirt.png");
+	game.texture.Load(Hash("corn"), "resources/entity/corn.png");
+	game.texture.Load(Hash("house"), "resources/entity/house.png");
+	game.texture.Load(Hash("house_destroyed"), "resources/entity/house_destroyed.png");
+	game.texture.Load(Hash("tornado_icon"), "resources/ui/tornado_icon.png");
+	game.texture.Load(Hash("tornado_icon_green"), "resources/ui/tornado_icon_green.png");
+	game.texture.Load(Hash("tornado_arrow"), "resources/ui/arrow.png");
+	game.texture.Load(Hash("speedometer"), "resources/ui/speedometer.png");
+	if (!game.sound.Has(Hash("tornado_sound"))) {
+		game.sound.Load(Hash("tornado_sound"), "resources/audio/tornado.ogg");
+	}
+	if (!game.sound.Has(Hash("tornado_wind_sound"))) {
+		game.sound.Load(Hash("tornado_wind_sound"), "resources/audio/wind.ogg");
+	}
+	if (!game.sound.Has(Hash("engine_sound"))) {
+		game.sound.Load(Hash("engine_sound"), "resources/audio/car_1.ogg");
+	}
+	if (!game.sound.Has(Hash("car_start"))) {
+		game.sound.Load(Hash("car_start"), "resources/audio/car_start.ogg");
+	}
+}
+
 class MainMenu : public Scene {
 public:
 	void Preload() {
-		game.texture.Load(Hash("tutorial_text"), "resources/ui/instructions.png");
-		game.texture.Load(Hash("grass"), "resources/entity/grass.png");
-		game.texture.Load(Hash("tall_grass"), "resources/entity/tall_grass.png");
-		game.texture.Load(Hash("dirt"), "resources/entity/dirt.png");
-		game.texture.Load(Hash("corn"), "resources/entity/corn.png");
-		game.texture.Load(Hash("house"), "resources/entity/house.png");
-		game.texture.Load(Hash("house_destroyed"), "resources/entity/house_destroyed.png");
-		game.texture.Load(Hash("tornado_icon"), "resources/ui/tornado_icon.png");
-		game.texture.Load(Hash("tornado_icon_green"), "resources/ui/tornado_icon_green.png");
-		game.texture.Load(Hash("tornado_arrow"), "resources/ui/arrow.png");
-		game.texture.Load(Hash("speedometer"), "resources/ui/speedometer.png");
-		if (!game.sound.Has(Hash("tornado_sound"))) {
-			game.sound.Load(Hash("tornado_sound"), "resources/audio/tornado.ogg");
-		}
-		if (!game.sound.Has(Hash("tornado_wind_sound"))) {
-			game.sound.Load(Hash("tornado_wind_sound"), "resources/audio/wind.ogg");
-		}
-		if (!game.sound.Has(Hash("engine_sound"))) {
-			game.sound.Load(Hash("engine_sound"), "resources/audio/car_1.ogg");
-		}
-		if (!game.sound.Has(Hash("car_start"))) {
-			game.sound.Load(Hash("car_start"), "resources/audio/car_start.ogg");
-		}
+		LoadGameResources();
 
 		if (!game.font.Has(Hash("menu_font"))) {
 			game.font.Load(Hash("menu_font"), "resources/font/retro_gaming.ttf", button_size.y);
@@ -2485,8 +4067,97 @@ public:
 	}
 };
 
+#ifdef BRACKEYS_JAM_LEVEL_RUNNER
+
+// Level id and settings parsed from the level runner command line.
+int level_runner_level{ 0 };
+std::shared_ptr<LevelRunConfig> level_runner_config;
+
+class LevelRunnerScene : public Scene {
+public:
+	void Init() final {
+		game.window.SetSize(resolution);
+
+		LoadGameResources();
+
+		std::size_t game_scene{ Hash("game") };
+		game.scene.Load<GameScene>(game_scene, level_runner_level, level_runner_config);
+		game.scene.AddActive(game_scene);
+	}
+};
+
+void PrintLevelRunnerUsage() {
+	PTGN_LOG(
+		"Usage: brackeys_jam_2024_level_runner --level <id> [--input <script.json>] [--dt "
+		"<seconds>] [--max-time <seconds>] [--steps-per-frame <count>] [--budget-ms <ms>] "
+		"[--threads <count>] [--draw-order <sorted|submission>] [--database <levels.bin>]"
+	);
+}
+
+// Steps a single level from resources/data/levels.json at a fixed dt with scripted input
+// and prints per system timings and the outcome. Returns 1 if the update exceeds the budget.
+int main(int argc, char** argv) {
+	level_runner_config = std::make_shared<LevelRunConfig>();
+
+	bool has_level{ false };
+
+	for (int i{ 1 }; i < argc; i++) {
+		std::string argument{ argv[i] };
+		if (i + 1 >= argc) {
+			PrintLevelRunnerUsage();
+			return 2;
+		}
+		std::string value{ argv[++i] };
+		if (argument == "--level") {
+			level_runner_level = std::stoi(value);
+			has_level		   = true;
+		} else if (argument == "--input") {
+			level_runner_config->script = InputScript{ value };
+		} else if (argument == "--dt") {
+			level_runner_config->dt = std::stof(value);
+		} else if (argument == "--max-time") {
+			level_runner_config->max_time = std::stof(value);
+		} else if (argument == "--steps-per-frame") {
+			level_runner_config->steps_per_frame = std::stoi(value);
+		} else if (argument == "--budget-ms") {
+			level_runner_config->budget_ms = std::stod(value);
+		} else if (argument == "--threads") {
+			job_thread_count = static_cast<std::size_t>(std::stoul(value));
+		} else if (argument == "--draw-order" && (value == "sorted" || value == "submission")) {
+			level_runner_config->sort_draws = value == "sorted";
+		} else if (argument == "--database") {
+			level_database_path = value;
+		} else {
+			PrintLevelRunnerUsage();
+			return 2;
+		}
+	}
+
+	if (!LoadLevelDatabase()) {
+		return 1;
+	}
+
+	if (!has_level || !GetLevelDatabase().HasLevel(level_runner_level) ||
+		level_runner_config->dt <= 0.0f || level_runner_config->steps_per_frame <= 0) {
+		PrintLevelRunnerUsage();
+		return 2;
+	}
+
+	game.Start<LevelRunnerScene>();
+
+	return level_runner_exit_code;
+}
+
+#else
+
 int main() {
+	if (!LoadLevelDatabase()) {
+		return 1;
+	}
+
 	game.Start<SetupScene>();
 
 	return 0;
 }
+
+#endif
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "wind_field.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DEBRIS_PARTICLES_SSE
+#endif
+
+// Per tornado constants used by the debris particle integration step.
+struct DebrisForces {
+	float center_x{ 0.0f };
+	float center_y{ 0.0f };
+	// Numerator of the inward pull, applied along the direction to the center divided by the
+	// squared distance. When sampling a WindField this instead scales the field suction.
+	float suction{ 0.0f };
+	// Numerator of the tangential pull, applied along the skewed direction to the center
+	// divided by the squared distance. When sampling a WindField this instead scales the field
+	// wind.
+	float wind{ 0.0f };
+	float turn_speed{ 0.0f };
+	// Particles closer than the inner radius or further than the outer radius are recycled.
+	float inner_radius2{ 0.0f };
+	float outer_radius2{ 0.0f };
+};
+
+// Fixed capacity debris particle store laid out as structure-of-arrays. Particles [0, alive)
+// are simulated, particles [alive, capacity) are free slots which can be respawned.
+class DebrisParticles {
+public:
+	void SetCapacity(std::size_t capacity) {
+		x.resize(capacity);
+		y.resize(capacity);
+		vx.resize(capacity);
+		vy.resize(capacity);
+		rotation.resize(capacity);
+		alive = 0;
+		limit = capacity;
+	}
+
+	// Caps the number of alive particles below the capacity, dropping any above the limit.
+	void SetLimit(std::size_t new_limit) {
+		limit = std::min(new_limit, GetCapacity());
+		alive = std::min(alive, limit);
+	}
+
+	[[nodiscard]] std::size_t GetCapacity() const {
+		return x.size();
+	}
+
+	[[nodiscard]] std::size_t GetAliveCount() const {
+		return alive;
+	}
+
+	// @return False if there are no free slots left below the limit.
+	bool Spawn(float position_x, float position_y, float velocity_x, float velocity_y) {
+		if (alive >= limit) {
+			return false;
+		}
+		x[alive]  = position_x;
+		y[alive]  = position_y;
+		vx[alive] = velocity_x;
+		vy[alive] = velocity_y;
+		alive++;
+		return true;
+	}
+
+	// Applies suction and wind to every alive particle, moves it, and then compacts particles
+	// which left the [inner, outer] radius band into the free slots at the end of the arrays.
+	// Velocity only carries spawn momentum, it is consumed and cleared by each step.
+	void Update(const DebrisForces& forces, float dt) {
+		std::size_t i{ 0 };
+
+#ifdef DEBRIS_PARTICLES_SSE
+		const __m128 center_x{ _mm_set1_ps(forces.center_x) };
+		const __m128 center_y{ _mm_set1_ps(forces.center_y) };
+		const __m128 suction{ _mm_set1_ps(forces.suction) };
+		const __m128 wind{ _mm_set1_ps(forces.wind) };
+		const __m128 step{ _mm_set1_ps(dt) };
+		const __m128 turn{ _mm_set1_ps(forces.turn_speed * dt) };
+		const __m128 zero{ _mm_setzero_ps() };
+
+		for (; i + 4 <= alive; i += 4) {
+			__m128 px{ _mm_loadu_ps(&x[i]) };
+			__m128 py{ _mm_loadu_ps(&y[i]) };
+			__m128 pvx{ _mm_loadu_ps(&vx[i]) };
+			__m128 pvy{ _mm_loadu_ps(&vy[i]) };
+
+			__m128 dx{ _mm_sub_ps(center_x, px) };
+			__m128 dy{ _mm_sub_ps(center_y, py) };
+			__m128 dist2{ _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)) };
+			__m128 scale{ _mm_div_ps(step, dist2) };
+
+			// suction * dir + wind * dir.Skewed(), where Skewed() of (x, y) is (-y, x).
+			__m128 ax{ _mm_sub_ps(_mm_mul_ps(dx, suction), _mm_mul_ps(dy, wind)) };
+			__m128 ay{ _mm_add_ps(_mm_mul_ps(dy, suction), _mm_mul_ps(dx, wind)) };
+
+			pvx = _mm_add_ps(pvx, _mm_mul_ps(ax, scale));
+			pvy = _mm_add_ps(pvy, _mm_mul_ps(ay, scale));
+
+			_mm_storeu_ps(&x[i], _mm_add_ps(px, _mm_mul_ps(pvx, step)));
+			_mm_storeu_ps(&y[i], _mm_add_ps(py, _mm_mul_ps(pvy, step)));
+			_mm_storeu_ps(&rotation[i], _mm_add_ps(_mm_loadu_ps(&rotation[i]), turn));
+			_mm_storeu_ps(&vx[i], zero);
+			_mm_storeu_ps(&vy[i], zero);
+		}
+#endif
+
+		for (; i < alive; i++) {
+			float dx{ forces.center_x - x[i] };
+			float dy{ forces.center_y - y[i] };
+			float scale{ dt / (dx * dx + dy * dy) };
+
+			vx[i] += (dx * forces.suction - dy * forces.wind) * scale;
+			vy[i] += (dy * forces.suction + dx * forces.wind) * scale;
+
+			x[i]		+= vx[i] * dt;
+			y[i]		+= vy[i] * dt;
+			rotation[i] += forces.turn_speed * dt;
+			vx[i]		 = 0.0f;
+			vy[i]		 = 0.0f;
+		}
+
+		Compact(forces);
+	}
+
+	// Same as Update but the pull is sampled from a wind field, so particles also feel the
+	// other tornadoes. Recycling still uses the radius band around forces.center.
+	void Update(const WindField& field, const DebrisForces& forces, float dt) {
+		for (std::size_t i{ 0 }; i < alive; i++) {
+			WindSample sample{ field.Sample(x[i], y[i]) };
+
+			vx[i] += (sample.suction_x * forces.suction + sample.wind_x * forces.wind) * dt;
+			vy[i] += (sample.suction_y * forces.suction + sample.wind_y * forces.wind) * dt;
+
+			x[i]		+= vx[i] * dt;
+			y[i]		+= vy[i] * dt;
+			rotation[i] += forces.turn_speed * dt;
+			vx[i]		 = 0.0f;
+			vy[i]		 = 0.0f;
+		}
+
+		Compact(forces);
+	}
+
+	// Moves and rotates every alive particle by the same amount.
+	void Offset(float offset_x, float offset_y, float offset_rotation) {
+		for (std::size_t i{ 0 }; i < alive; i++) {
+			x[i]		+= offset_x;
+			y[i]		+= offset_y;
+			rotation[i] += offset_rotation;
+		}
+	}
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> vx;
+	std::vector<float> vy;
+	std::vector<float> rotation;
+
+private:
+	// Swap removes recycled particles so that alive particles stay contiguous.
+	void Compact(const DebrisForces& forces) {
+		std::size_t i{ 0 };
+		while (i < alive) {
+			float dx{ x[i] - forces.center_x };
+			float dy{ y[i] - forces.center_y };
+			float dist2{ dx * dx + dy * dy };
+			if (dist2 >= forces.inner_radius2 && dist2 <= forces.outer_radius2) {
+				i++;
+				continue;
+			}
+			alive--;
+			x[i]		= x[alive];
+			y[i]		= y[alive];
+			vx[i]		= vx[alive];
+			vy[i]		= vy[alive];
+			rotation[i] = rotation[alive];
+		}
+	}
+
+	std::size_t alive{ 0 };
+	std::size_t limit{ 0 };
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "protegon/protegon.h"
+
+// Per sprite data of a group of sprites sharing one texture and size, see DrawQueue::AddGroup().
+struct GroupedSprite {
+	ptgn::V2_float position;
+	float rotation{ 0.0f };
+	float scale{ 1.0f };
+	ptgn::Color tint{ ptgn::color::White };
+};
+
+// Forwards draws to game.renderer and counts the calls it actually receives, so that draw
+// orders are compared at the renderer rather than by the keys of the queue. The engine does not
+// expose its own batch count, state changes are the closest observable proxy.
+class CountingRenderer {
+public:
+	struct Counts {
+		// Calls to game.renderer.DrawTexture.
+		std::size_t draw_calls{ 0 };
+		// Calls whose texture or z index differ from the previous call.
+		std::size_t state_changes{ 0 };
+	};
+
+	void DrawTexture(
+		const ptgn::Texture& texture, const ptgn::V2_float& position, const ptgn::V2_float& size,
+		const ptgn::V2_float& source_position, const ptgn::V2_float& source_size,
+		ptgn::Origin origin, ptgn::Flip flip, float rotation,
+		const ptgn::V2_float& rotation_center, float z, const ptgn::Color& tint
+	) {
+		if (counts.draw_calls == 0 || !(texture == previous_texture) || z != previous_z) {
+			counts.state_changes++;
+		}
+		counts.draw_calls++;
+		previous_texture = texture;
+		previous_z		 = z;
+		ptgn::game.renderer.DrawTexture(
+			texture, position, size, source_position, source_size, origin, flip, rotation,
+			rotation_center, z, tint
+		);
+	}
+
+	void Flush() {
+		ptgn::game.renderer.Flush();
+	}
+
+	// @return Counts since the previous call.
+	Counts TakeCounts() {
+		Counts taken{ counts };
+		counts			 = {};
+		previous_texture = {};
+		return taken;
+	}
+
+private:
+	Counts counts;
+	ptgn::Texture previous_texture;
+	float previous_z{ 0.0f };
+};
+
+// Sprites submitted during a frame which are sorted once by (layer, texture, depth) before being
+// handed to the renderer, so that draws of the same texture within a layer form one batch.
+// Sprites with equal keys keep their submission order.
+class DrawQueue {
+public:
+	struct Stats {
+		// Calls to Add() and AddGroup(), which are sort keys rather than renderer calls.
+		std::size_t submissions{ 0 };
+		// Calls to AddGroup() which were not trimmed to nothing.
+		std::size_t groups{ 0 };
+		// Sprites drawn, counting every sprite of a group.
+		std::size_t sprites{ 0 };
+		// Layer or texture changes in the order handed to the renderer.
+		std::size_t batches{ 0 };
+		// What game.renderer received during the flush.
+		CountingRenderer::Counts renderer;
+	};
+
+	// Sorting can be disabled to submit in the order sprites were added, each at its layer as the
+	// z index, which is how the scene drew before it was queued.
+	void SetSorted(bool sorted) {
+		this->sorted = sorted;
+	}
+
+	[[nodiscard]] bool IsSorted() const {
+		return sorted;
+	}
+
+	// Same arguments as game.renderer.DrawTexture, with the z index replaced by a layer.
+	// @param depth Orders sprites sharing a layer and texture, lower depths are drawn first.
+	void Add(
+		const ptgn::Texture& texture, const ptgn::V2_float& position, const ptgn::V2_float& size,
+		const ptgn::V2_float& source_position = {}, const ptgn::V2_float& source_size = {},
+		ptgn::Origin origin = ptgn::Origin::Center, ptgn::Flip flip = ptgn::Flip::None,
+		float rotation = 0.0f, const ptgn::V2_float& rotation_center = { 0.5f, 0.5f },
+		std::uint8_t layer = 0, const ptgn::Color& tint = ptgn::color::White,
+		std::uint16_t depth = 0
+	) {
+		Push(
+			texture, layer, depth,
+			{ position, size, source_position, source_size, origin, flip, rotation,
+			  rotation_center, tint, layer }
+		);
+	}
+
+	// Queues count sprites of one texture as a single submission under one sort key. This is not
+	// instancing: the engine has no instanced draw, so Flush() still hands every sprite of the
+	// group to the renderer as its own DrawTexture call. A group only saves the per sprite key,
+	// record and sort work. The caller writes the sprites through the returned pointer, which is
+	// valid until the next call to the queue, and may then drop unused ones with TrimGroup().
+	// @param size Size of a grouped sprite with a scale of 1.
+	[[nodiscard]] GroupedSprite* AddGroup(
+		const ptgn::Texture& texture, const ptgn::V2_float& size, std::size_t count,
+		std::uint8_t layer = 0, ptgn::Origin origin = ptgn::Origin::Center,
+		std::uint16_t depth = 0
+	) {
+		Sprite sprite;
+		sprite.size			 = size;
+		sprite.origin		 = origin;
+		sprite.layer		 = layer;
+		sprite.grouped		 = true;
+		sprite.first_grouped = grouped_sprites.size();
+		sprite.grouped_count = count;
+		Push(texture, layer, depth, sprite);
+		grouped_sprites.resize(grouped_sprites.size() + count);
+		return grouped_sprites.data() + sprite.first_grouped;
+	}
+
+	// Keeps the first count sprites of the last AddGroup() call, removing the submission
+	// entirely if count is 0.
+	void TrimGroup(std::size_t count) {
+		PTGN_ASSERT(!sprites.empty() && sprites.back().grouped);
+		Sprite& sprite{ sprites.back() };
+		PTGN_ASSERT(count <= sprite.grouped_count);
+		grouped_sprites.resize(sprite.first_grouped + count);
+		sprite.grouped_count = count;
+		if (count == 0) {
+			sprites.pop_back();
+			keys.pop_back();
+		}
+	}
+
+	// Sorts the queued sprites and submits them to the renderer. The renderer groups draws by z
+	// index, so sorted sprites are all submitted at z 0 and flushed immediately, otherwise it
+	// would reorder them by layer again and merge later direct draws into the same groups.
+	Stats Flush() {
+		Stats stats;
+		stats.submissions = sprites.size();
+
+		if (sorted) {
+			Sort();
+		}
+
+		stats.batches = CountBatches();
+
+		for (std::uint64_t key : keys) {
+			const Sprite& sprite{ sprites[key & index_mask] };
+			const ptgn::Texture& texture{ textures[GetSlot(key)] };
+			auto z{ sorted ? 0.0f : static_cast<float>(sprite.layer) };
+			if (!sprite.grouped) {
+				renderer.DrawTexture(
+					texture, sprite.position, sprite.size, sprite.source_position,
+					sprite.source_size, sprite.origin, sprite.flip, sprite.rotation,
+					sprite.rotation_center, z, sprite.tint
+				);
+				stats.sprites++;
+				continue;
+			}
+			const GroupedSprite* grouped{ grouped_sprites.data() + sprite.first_grouped };
+			const GroupedSprite* end{ grouped + sprite.grouped_count };
+			for (; grouped != end; ++grouped) {
+				renderer.DrawTexture(
+					texture, grouped->position, sprite.size * grouped->scale, {}, {},
+					sprite.origin, ptgn::Flip::None, grouped->rotation, { 0.5f, 0.5f }, z,
+					grouped->tint
+				);
+			}
+			stats.groups++;
+			stats.sprites += sprite.grouped_count;
+		}
+
+		if (sorted && !keys.empty()) {
+			renderer.Flush();
+		}
+
+		stats.renderer = renderer.TakeCounts();
+
+		PTGN_ASSERT(
+			stats.renderer.draw_calls == stats.sprites,
+			"Every queued sprite, grouped or not, must reach the renderer exactly once"
+		);
+
+		keys.clear();
+		sprites.clear();
+		grouped_sprites.clear();
+		textures.clear();
+		last_slot = no_slot;
+
+		return stats;
+	}
+
+private:
+	struct Sprite {
+		ptgn::V2_float position;
+		ptgn::V2_float size;
+		ptgn::V2_float source_position;
+		ptgn::V2_float source_size;
+		ptgn::Origin origin{ ptgn::Origin::Center };
+		ptgn::Flip flip{ ptgn::Flip::None };
+		float rotation{ 0.0f };
+		ptgn::V2_float rotation_center;
+		ptgn::Color tint;
+		std::uint8_t layer{ 0 };
+		// Groups draw grouped sprites [first_grouped, first_grouped + grouped_count) with the
+		// size and origin above.
+		bool grouped{ false };
+		std::size_t first_grouped{ 0 };
+		std::size_t grouped_count{ 0 };
+	};
+
+	// Sorted keys hold the sprite index in their lowest bits: | layer | slot | depth | index |.
+	constexpr static std::size_t index_bits{ 24 };
+	constexpr static std::uint64_t index_mask{ (std::uint64_t{ 1 } << index_bits) - 1 };
+	constexpr static std::size_t max_sprites{ std::size_t{ 1 } << index_bits };
+	constexpr static std::size_t key_bytes{ 5 };
+	constexpr static std::uint16_t no_slot{ 0xFFFF };
+
+	void Push(
+		const ptgn::Texture& texture, std::uint8_t layer, std::uint16_t depth, const Sprite& sprite
+	) {
+		PTGN_ASSERT(sprites.size() < max_sprites, "Too many sprites queued in one frame");
+
+		std::uint64_t key{ (static_cast<std::uint64_t>(layer) << 32) |
+						   (static_cast<std::uint64_t>(GetSlot(texture)) << 16) | depth };
+
+		keys.push_back((key << index_bits) | sprites.size());
+		sprites.push_back(sprite);
+	}
+
+	[[nodiscard]] static std::uint16_t GetSlot(std::uint64_t key) {
+		return static_cast<std::uint16_t>(key >> (index_bits + 16));
+	}
+
+	// Textures are numbered in the order they are first queued within the frame.
+	std::uint16_t GetSlot(const ptgn::Texture& texture) {
+		// Consecutive sprites mostly share a texture.
+		if (last_slot != no_slot && textures[last_slot] == texture) {
+			return last_slot;
+		}
+		for (std::size_t i{ 0 }; i < textures.size(); i++) {
+			if (textures[i] == texture) {
+				last_slot = static_cast<std::uint16_t>(i);
+				return last_slot;
+			}
+		}
+		PTGN_ASSERT(textures.size() < no_slot, "Too many textures queued in one frame");
+		last_slot = static_cast<std::uint16_t>(textures.size());
+		textures.push_back(texture);
+		return last_slot;
+	}
+
+	// Batches are runs of sprites sharing a layer and texture.
+	[[nodiscard]] std::size_t CountBatches() const {
+		std::size_t batches{ 0 };
+		std::uint64_t previous{ 0 };
+		for (std::size_t i{ 0 }; i < keys.size(); i++) {
+			// Drops the depth and index bits.
+			std::uint64_t batch{ keys[i] >> (index_bits + 16) };
+			if (i == 0 || batch != previous) {
+				batches++;
+			}
+			previous = batch;
+		}
+		return batches;
+	}
+
+	// Least significant digit radix sort over the key bytes above the index. Each pass is
+	// stable, so sprites with equal keys keep their submission order.
+	void Sort() {
+		scratch.resize(keys.size());
+		for (std::size_t byte{ 0 }; byte < key_bytes; byte++) {
+			std::size_t shift{ index_bits + byte * 8 };
+
+			std::array<std::size_t, 256> offsets{};
+			for (std::uint64_t key : keys) {
+				offsets[(key >> shift) & 0xFF]++;
+			}
+
+			// Every key shares this byte.
+			if (!keys.empty() && offsets[(keys.front() >> shift) & 0xFF] == keys.size()) {
+				continue;
+			}
+
+			std::size_t total{ 0 };
+			for (auto& offset : offsets) {
+				std::size_t count{ offset };
+				offset			  = total;
+				total			 += count;
+			}
+
+			for (std::uint64_t key : keys) {
+				scratch[offsets[(key >> shift) & 0xFF]++] = key;
+			}
+			keys.swap(scratch);
+		}
+	}
+
+	std::vector<std::uint64_t> keys;
+	std::vector<std::uint64_t> scratch;
+	std::vector<Sprite> sprites;
+	std::vector<GroupedSprite> grouped_sprites;
+	std::vector<ptgn::Texture> textures;
+	std::uint16_t last_slot{ no_slot };
+	bool sorted{ true };
+	CountingRenderer renderer;
+};
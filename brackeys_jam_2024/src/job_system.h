@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads running fork/join loops. Every thread owns a queue of jobs: it
+// takes work from the back of its own queue and, once that is empty, steals from the front of
+// the other queues. The thread calling ParallelFor() works through jobs until its loop is
+// finished and only sleeps once every job is taken, so loops may be nested inside jobs.
+class JobSystem {
+public:
+	// @param thread_count Total threads including the calling thread, 0 uses the hardware
+	// concurrency.
+	explicit JobSystem(std::size_t thread_count = 0) {
+#ifdef __EMSCRIPTEN__
+		// Web builds are compiled without pthread support.
+		thread_count = 1;
+#endif
+		if (thread_count == 0) {
+			thread_count = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		// Queue 0 belongs to the threads which are not workers.
+		for (std::size_t i{ 0 }; i < thread_count; i++) {
+			queues.push_back(std::make_unique<Queue>());
+		}
+
+		workers.reserve(thread_count - 1);
+		for (std::size_t i{ 1 }; i < thread_count; i++) {
+			workers.emplace_back([this, i]() { Work(i); });
+		}
+	}
+
+	~JobSystem() {
+		{
+			std::scoped_lock lock{ sleep_mutex };
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	JobSystem(const JobSystem&)			   = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	[[nodiscard]] std::size_t GetThreadCount() const {
+		return queues.size();
+	}
+
+	// Calls function(i) for every i in [0, count) and returns once all calls have finished.
+	// Indices are handed out in batches of grain_size. Calls may run concurrently, so they must
+	// only write to data owned by their index.
+	template <typename F>
+	void ParallelFor(std::size_t count, const F& function, std::size_t grain_size = 1) {
+		if (count == 0) {
+			return;
+		}
+
+		grain_size = std::max<std::size_t>(grain_size, 1);
+
+		if (queues.size() == 1 || count <= grain_size) {
+			for (std::size_t i{ 0 }; i < count; i++) {
+				function(i);
+			}
+			return;
+		}
+
+		const std::function<void(std::size_t)> call{ std::cref(function) };
+
+		std::size_t job_count{ (count + grain_size - 1) / grain_size };
+
+		std::atomic<std::size_t> remaining{ job_count };
+
+		// Spread the batches over every queue so that idle workers find work without stealing.
+		for (std::size_t j{ 0 }; j < job_count; j++) {
+			Job job{ &call, j * grain_size, std::min(count, (j + 1) * grain_size), &remaining };
+			Queue& queue{ *queues[(queue_index + j) % queues.size()] };
+			std::scoped_lock lock{ queue.mutex };
+			queue.jobs.push_back(job);
+			// Counted under the queue lock so that taking the job can never precede its count.
+			queued_jobs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Notify();
+
+		while (remaining.load(std::memory_order_acquire) > 0) {
+			Job job;
+			if (TryTake(job)) {
+				Run(job);
+				continue;
+			}
+			// Remaining jobs are running on other threads, sleep until they finish or until
+			// another loop queues jobs which this thread can help with.
+			std::unique_lock lock{ sleep_mutex };
+			wake.wait(lock, [&]() {
+				return remaining.load(std::memory_order_acquire) == 0 ||
+					   queued_jobs.load(std::memory_order_relaxed) > 0;
+			});
+		}
+	}
+
+private:
+	struct Job {
+		const std::function<void(std::size_t)>* function{ nullptr };
+		std::size_t begin{ 0 };
+		std::size_t end{ 0 };
+		std::atomic<std::size_t>* remaining{ nullptr };
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void Work(std::size_t index) {
+		queue_index = index;
+		while (true) {
+			Job job;
+			if (TryTake(job)) {
+				Run(job);
+				continue;
+			}
+			std::unique_lock lock{ sleep_mutex };
+			wake.wait(lock, [&]() {
+				return stopping || queued_jobs.load(std::memory_order_relaxed) > 0;
+			});
+			if (stopping) {
+				return;
+			}
+		}
+	}
+
+	// Pops from the back of this thread's queue, otherwise steals from the front of another.
+	bool TryTake(Job& job) {
+		for (std::size_t i{ 0 }; i < queues.size(); i++) {
+			bool own{ i == 0 };
+			Queue& queue{ *queues[(queue_index + i) % queues.size()] };
+			std::scoped_lock lock{ queue.mutex };
+			if (queue.jobs.empty()) {
+				continue;
+			}
+			if (own) {
+				job = queue.jobs.back();
+				queue.jobs.pop_back();
+			} else {
+				job = queue.jobs.front();
+				queue.jobs.pop_front();
+			}
+			queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	void Run(const Job& job) {
+		for (std::size_t i{ job.begin }; i < job.end; i++) {
+			(*job.function)(i);
+		}
+		// The caller may return as soon as this reaches zero, so job is not used afterwards.
+		if (job.remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			Notify();
+		}
+	}
+
+	// Locking before notifying ensures a thread which just found nothing to do is already
+	// waiting and does not miss the wake up.
+	void Notify() {
+		{
+			std::scoped_lock lock{ sleep_mutex };
+		}
+		wake.notify_all();
+	}
+
+	// Index of the queue owned by the current thread.
+	inline static thread_local std::size_t queue_index{ 0 };
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	// Jobs pushed to a queue which have not been taken yet, only changed under a queue lock.
+	std::atomic<std::size_t> queued_jobs{ 0 };
+	bool stopping{ false };
+};
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LEVEL_DATABASE_MMAP
+#endif
+
+#include "protegon/protegon.h"
+
+// Binary level table cooked from resources/data/levels.json by tools/level_cooker.cpp.
+// The file is a header followed by flat arrays of the records below, all 4 byte aligned, so it
+// can be used in place after being mapped or read into memory. Levels are indexed by id.
+
+namespace level_database {
+
+constexpr std::uint32_t magic{ 0x564C4A42 }; // "BJLV"
+// Increment whenever a record layout changes.
+constexpr std::uint32_t version{ 2 };
+
+// Slice [first, first + count) of one of the record arrays.
+struct Range {
+	std::uint32_t first{ 0 };
+	std::uint32_t count{ 0 };
+};
+
+// Null terminated string of length bytes inside the string blob.
+struct StringRef {
+	std::uint32_t offset{ 0 };
+	std::uint32_t length{ 0 };
+};
+
+enum TornadoFlags : std::uint32_t {
+	Static	 = 1 << 0,
+	Sequence = 1 << 1,
+	Custom1	 = 1 << 2,
+};
+
+struct SequenceKeyframe {
+	float x{ 0.0f };
+	float y{ 0.0f };
+	std::int32_t time_to_next_ms{ 0 };
+};
+
+struct Tornado {
+	std::uint32_t flags{ 0 };
+	StringRef texture;
+	float turn_speed{ 0.0f };
+	float increment_speed{ 0.0f };
+	float escape_radius{ 0.0f };
+	float warning_radius{ 0.0f };
+	float data_radius{ 0.0f };
+	float gravity_radius{ 0.0f };
+	// Static position or the first sequence keyframe position.
+	float x{ 0.0f };
+	float y{ 0.0f };
+	// Range of SequenceKeyframes.
+	Range sequence;
+	// Custom1 motion.
+	float rotation_x{ 0.0f };
+	float rotation_y{ 0.0f };
+	float end_x{ 0.0f };
+	float end_y{ 0.0f };
+	std::int32_t rotation_time_ms{ 0 };
+	std::int32_t linear_time_ms{ 0 };
+};
+
+struct Level {
+	std::int32_t id{ 0 };
+	std::uint32_t seed{ 0 };
+	std::int32_t screen_width{ 0 };
+	std::int32_t screen_height{ 0 };
+	std::uint32_t streaming{ 0 };
+	// Node spacing of the level's wind field, 0 if tornado forces are evaluated per tornado.
+	float wind_field_cell_size{ 0.0f };
+	StringRef win_text;
+	StringRef ui_icon;
+	StringRef details;
+	// Range of Tornadoes.
+	Range tornadoes;
+};
+
+struct DifficultyLayer {
+	StringRef music;
+};
+
+struct Header {
+	std::uint32_t magic{ level_database::magic };
+	std::uint32_t version{ level_database::version };
+	float car_volume{ 0.0f };
+	float music_volume{ 0.0f };
+	float tornadoes_max_volume{ 0.0f };
+	float tornadoes_ambient_volume{ 0.0f };
+	// Byte offsets from the start of the file and element counts of each array.
+	Range levels;
+	Range tornadoes;
+	Range sequence_keyframes;
+	Range difficulty_layers;
+	// Each branch is a Range of branch_levels.
+	Range branches;
+	Range branch_levels;
+	Range completed_levels;
+	Range strings;
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<Level>);
+static_assert(std::is_trivially_copyable_v<Tornado>);
+static_assert(sizeof(Header) % 4 == 0 && sizeof(Level) % 4 == 0 && sizeof(Tornado) % 4 == 0);
+
+// Read only view of a cooked level database file. Nothing is parsed on open, lookups index
+// straight into the mapped file.
+class LevelDatabase {
+public:
+	LevelDatabase() = default;
+
+	explicit LevelDatabase(const ptgn::path& file_path) {
+		Open(file_path);
+	}
+
+	~LevelDatabase() {
+		Close();
+	}
+
+	LevelDatabase(const LevelDatabase&)			   = delete;
+	LevelDatabase& operator=(const LevelDatabase&) = delete;
+
+	// @throw std::runtime_error if the file is missing, cannot be read, was cooked by a
+	// different version or any array lies outside of the file.
+	void Open(const ptgn::path& file_path) {
+		Close();
+
+		const std::string name{ file_path.string() };
+
+		Check(
+			ptgn::FileExists(file_path), "Level database ", name,
+			" could not be found, it is cooked from levels.json by the level_cooker build step"
+		);
+
+#ifdef LEVEL_DATABASE_MMAP
+		int file{ ::open(name.c_str(), O_RDONLY) };
+		Check(file != -1, "Failed to open level database ", name);
+		struct stat info {};
+		if (::fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+			::close(file);
+			Check(false, "Level database ", name, " is truncated");
+		}
+		size		= static_cast<std::size_t>(info.st_size);
+		void* start = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (start == MAP_FAILED) {
+			size = 0;
+			Check(false, "Failed to map level database ", name);
+		}
+		mapping = start;
+		data	= static_cast<const std::byte*>(start);
+#else
+		std::ifstream file{ file_path, std::ios::binary | std::ios::ate };
+		Check(static_cast<bool>(file), "Failed to open level database ", name);
+		size = static_cast<std::size_t>(file.tellg());
+		Check(size >= sizeof(Header), "Level database ", name, " is truncated");
+		// Backed by 4 byte words to keep the records aligned.
+		buffer.resize((size + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+		Check(static_cast<bool>(file), "Failed to read level database ", name);
+		data = reinterpret_cast<const std::byte*>(buffer.data());
+#endif
+
+		try {
+			Validate(name);
+		} catch (...) {
+			Close();
+			throw;
+		}
+	}
+
+	void Close() {
+#ifdef LEVEL_DATABASE_MMAP
+		if (mapping != nullptr) {
+			::munmap(mapping, size);
+			mapping = nullptr;
+		}
+#else
+		buffer.clear();
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	[[nodiscard]] bool IsOpen() const {
+		return data != nullptr;
+	}
+
+	[[nodiscard]] const Header& GetHeader() const {
+		PTGN_ASSERT(IsOpen());
+		return *reinterpret_cast<const Header*>(data);
+	}
+
+	[[nodiscard]] std::size_t GetLevelCount() const {
+		return GetHeader().levels.count;
+	}
+
+	[[nodiscard]] bool HasLevel(int id) const {
+		return id >= 0 && static_cast<std::size_t>(id) < GetLevelCount();
+	}
+
+	[[nodiscard]] const Level& GetLevel(int id) const {
+		PTGN_ASSERT(HasLevel(id), "Level database does not contain level: ", id);
+		return GetArray<Level>(GetHeader().levels)[id];
+	}
+
+	[[nodiscard]] const Tornado* GetTornadoes(const Level& level) const {
+		return GetArray<Tornado>(GetHeader().tornadoes) + level.tornadoes.first;
+	}
+
+	[[nodiscard]] const SequenceKeyframe* GetSequence(const Tornado& tornado) const {
+		return GetArray<SequenceKeyframe>(GetHeader().sequence_keyframes) +
+			   tornado.sequence.first;
+	}
+
+	[[nodiscard]] std::size_t GetDifficultyLayerCount() const {
+		return GetHeader().difficulty_layers.count;
+	}
+
+	[[nodiscard]] const DifficultyLayer& GetDifficultyLayer(std::size_t index) const {
+		PTGN_ASSERT(index < GetDifficultyLayerCount());
+		return GetArray<DifficultyLayer>(GetHeader().difficulty_layers)[index];
+	}
+
+	[[nodiscard]] std::size_t GetBranchCount() const {
+		return GetHeader().branches.count;
+	}
+
+	// @return Range of levels in the branch, indexed with GetBranchLevel.
+	[[nodiscard]] const Range& GetBranch(std::size_t index) const {
+		PTGN_ASSERT(index < GetBranchCount());
+		return GetArray<Range>(GetHeader().branches)[index];
+	}
+
+	[[nodiscard]] int GetBranchLevel(const Range& branch, std::size_t index) const {
+		PTGN_ASSERT(index < branch.count);
+		return GetArray<std::int32_t>(GetHeader().branch_levels)[branch.first + index];
+	}
+
+	[[nodiscard]] std::size_t GetCompletedLevelCount() const {
+		return GetHeader().completed_levels.count;
+	}
+
+	[[nodiscard]] int GetCompletedLevel(std::size_t index) const {
+		PTGN_ASSERT(index < GetCompletedLevelCount());
+		return GetArray<std::int32_t>(GetHeader().completed_levels)[index];
+	}
+
+	[[nodiscard]] std::string_view GetString(const StringRef& string) const {
+		return { GetArray<char>(GetHeader().strings) + string.offset, string.length };
+	}
+
+private:
+	template <typename T>
+	[[nodiscard]] const T* GetArray(const Range& range) const {
+		return reinterpret_cast<const T*>(data + range.first);
+	}
+
+	template <typename... Ts>
+	static void Check(bool condition, const Ts&... message) {
+		if (condition) {
+			return;
+		}
+		std::ostringstream stream;
+		(stream << ... << message);
+		throw std::runtime_error{ stream.str() };
+	}
+
+	// Checks every offset stored in the file, so that lookups never leave the mapped range.
+	void Validate(const std::string& name) const {
+		const Header& header{ GetHeader() };
+		Check(
+			header.magic == magic && header.version == version, "Level database ", name,
+			" is out of date, rebuild to recook it"
+		);
+		ValidateArray<Level>(header.levels);
+		ValidateArray<Tornado>(header.tornadoes);
+		ValidateArray<SequenceKeyframe>(header.sequence_keyframes);
+		ValidateArray<DifficultyLayer>(header.difficulty_layers);
+		ValidateArray<Range>(header.branches);
+		ValidateArray<std::int32_t>(header.branch_levels);
+		ValidateArray<std::int32_t>(header.completed_levels);
+		ValidateArray<char>(header.strings);
+
+		for (std::size_t i{ 0 }; i < header.levels.count; i++) {
+			const Level& level{ GetArray<Level>(header.levels)[i] };
+			ValidateSlice(level.tornadoes, header.tornadoes);
+			ValidateString(level.win_text);
+			ValidateString(level.ui_icon);
+			ValidateString(level.details);
+		}
+		for (std::size_t i{ 0 }; i < header.tornadoes.count; i++) {
+			const Tornado& tornado{ GetArray<Tornado>(header.tornadoes)[i] };
+			ValidateSlice(tornado.sequence, header.sequence_keyframes);
+			ValidateString(tornado.texture);
+		}
+		for (std::size_t i{ 0 }; i < header.difficulty_layers.count; i++) {
+			ValidateString(GetArray<DifficultyLayer>(header.difficulty_layers)[i].music);
+		}
+		for (std::size_t i{ 0 }; i < header.branches.count; i++) {
+			ValidateSlice(GetArray<Range>(header.branches)[i], header.branch_levels);
+		}
+	}
+
+	template <typename T>
+	void ValidateArray(const Range& range) const {
+		Check(range.first % alignof(T) == 0, "Misaligned level database array");
+		Check(
+			range.first <= size && range.count <= (size - range.first) / sizeof(T),
+			"Level database array exceeds the file size"
+		);
+	}
+
+	// @param slice Element range into the array described by range.
+	static void ValidateSlice(const Range& slice, const Range& range) {
+		Check(
+			slice.first <= range.count && slice.count <= range.count - slice.first,
+			"Level database record refers outside of its array"
+		);
+	}
+
+	void ValidateString(const StringRef& string) const {
+		const Range& strings{ GetHeader().strings };
+		Check(
+			string.offset < strings.count && string.length < strings.count - string.offset &&
+				GetArray<char>(strings)[string.offset + string.length] == '\0',
+			"Level database string exceeds the string blob"
+		);
+	}
+
+	const std::byte* data{ nullptr };
+	std::size_t size{ 0 };
+
+#ifdef LEVEL_DATABASE_MMAP
+	void* mapping{ nullptr };
+#else
+	std::vector<std::uint32_t> buffer;
+#endif
+};
+
+} // namespace level_database
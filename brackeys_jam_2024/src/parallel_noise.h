@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "protegon/protegon.h"
+
+// Bands smaller than this do not amortize the cost of starting a thread or checking for a stop.
+constexpr int min_noise_band_rows{ 16 };
+
+// Generates the same map as FractalNoise::Generate(noise, {}, size, properties) by splitting
+// the grid into bands of rows which are generated concurrently. Every cell only depends on its
+// own coordinate, so generating a band at its row offset yields the exact values the full grid
+// would have at those rows.
+// @param thread_count 0 uses the hardware concurrency.
+inline std::vector<float> GenerateFractalNoise(
+	const ptgn::ValueNoise& noise, const ptgn::V2_int& size,
+	const ptgn::NoiseProperties& properties, std::size_t thread_count = 0
+) {
+	PTGN_ASSERT(size.x > 0 && size.y > 0);
+
+#ifdef __EMSCRIPTEN__
+	// Web builds are compiled without pthread support.
+	thread_count = 1;
+#endif
+
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	thread_count = std::min(
+		thread_count, static_cast<std::size_t>(std::max(1, size.y / min_noise_band_rows))
+	);
+
+	if (thread_count <= 1) {
+		return ptgn::FractalNoise::Generate(noise, {}, size, properties);
+	}
+
+	std::vector<float> noise_map(static_cast<std::size_t>(size.x) * size.y);
+
+	int band_rows{ (size.y + static_cast<int>(thread_count) - 1) /
+				   static_cast<int>(thread_count) };
+
+	auto generate_band = [&](int first_row) {
+		int rows{ std::min(band_rows, size.y - first_row) };
+		std::vector<float> band{ ptgn::FractalNoise::Generate(
+			noise, ptgn::V2_float{ 0.0f, static_cast<float>(first_row) }, { size.x, rows },
+			properties
+		) };
+		PTGN_ASSERT(band.size() == static_cast<std::size_t>(size.x) * rows);
+		std::copy(
+			band.begin(), band.end(),
+			noise_map.begin() + static_cast<std::ptrdiff_t>(first_row) * size.x
+		);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(thread_count - 1);
+
+	// The calling thread generates the first band itself.
+	for (int first_row{ band_rows }; first_row < size.y; first_row += band_rows) {
+		workers.emplace_back(generate_band, first_row);
+	}
+
+	generate_band(0);
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	return noise_map;
+}
+
+// Generates the same map as above on the calling thread only, one band of rows at a time, so
+// that background generation occupies a single core and can be abandoned between bands.
+// @param stopped Checked before every band, set by another thread to abandon the generation.
+// @return Empty map if stopped was set before the last band finished.
+inline std::vector<float> GenerateFractalNoise(
+	const ptgn::ValueNoise& noise, const ptgn::V2_int& size,
+	const ptgn::NoiseProperties& properties, const std::atomic<bool>& stopped
+) {
+	PTGN_ASSERT(size.x > 0 && size.y > 0);
+
+	std::vector<float> noise_map(static_cast<std::size_t>(size.x) * size.y);
+
+	for (int first_row{ 0 }; first_row < size.y; first_row += min_noise_band_rows) {
+		if (stopped) {
+			return {};
+		}
+		int rows{ std::min(min_noise_band_rows, size.y - first_row) };
+		std::vector<float> band{ ptgn::FractalNoise::Generate(
+			noise, ptgn::V2_float{ 0.0f, static_cast<float>(first_row) }, { size.x, rows },
+			properties
+		) };
+		PTGN_ASSERT(band.size() == static_cast<std::size_t>(size.x) * rows);
+		std::copy(
+			band.begin(), band.end(),
+			noise_map.begin() + static_cast<std::ptrdiff_t>(first_row) * size.x
+		);
+	}
+
+	return noise_map;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Tornado terms accumulated into the wind field.
+struct WindSource {
+	float x{ 0.0f };
+	float y{ 0.0f };
+	float velocity_x{ 0.0f };
+	float velocity_y{ 0.0f };
+	// Numerator of the inward pull before it is scaled by the thrust of the sampler.
+	float suction{ 0.0f };
+	// Numerator of the tangential pull before it is divided by the pull resistance of the
+	// sampler.
+	float wind{ 0.0f };
+	// Sources only affect positions within this radius.
+	float radius{ 0.0f };
+};
+
+// Sum of the source terms at a position, see WindField::Sample.
+struct WindSample {
+	float suction_x{ 0.0f };
+	float suction_y{ 0.0f };
+	float wind_x{ 0.0f };
+	float wind_y{ 0.0f };
+	// Sum of the velocities of the covering sources.
+	float velocity_x{ 0.0f };
+	float velocity_y{ 0.0f };
+	// Number of sources covering the position.
+	float coverage{ 0.0f };
+};
+
+// Coarse grid of tornado forces which is rebuilt from every tornado once per tick, so that the
+// player, debris and grass sample a constant cost field instead of iterating tornadoes.
+// Sources are evaluated at the grid nodes and sampled with bilinear interpolation.
+class WindField {
+public:
+	// @param cell_size Distance between grid nodes, 0 disables the field.
+	void Create(float width, float height, float cell_size) {
+		this->cell_size = cell_size;
+		if (cell_size <= 0.0f) {
+			nodes.clear();
+			columns = 0;
+			rows	= 0;
+			return;
+		}
+		columns = static_cast<int>(std::ceil(width / cell_size)) + 1;
+		rows	= static_cast<int>(std::ceil(height / cell_size)) + 1;
+		nodes.assign(static_cast<std::size_t>(columns) * rows, {});
+	}
+
+	[[nodiscard]] bool IsEnabled() const {
+		return cell_size > 0.0f;
+	}
+
+	[[nodiscard]] float GetCellSize() const {
+		return cell_size;
+	}
+
+	void Clear() {
+		std::fill(nodes.begin(), nodes.end(), WindSample{});
+	}
+
+	void Add(const WindSource& source) {
+		// Range of nodes within the bounding box of the source radius.
+		auto first_node = [&](float position) {
+			return std::max(0, static_cast<int>(std::ceil(position / cell_size)));
+		};
+		auto last_node = [&](float position, int count) {
+			return std::min(count - 1, static_cast<int>(std::floor(position / cell_size)));
+		};
+
+		int min_x{ first_node(source.x - source.radius) };
+		int min_y{ first_node(source.y - source.radius) };
+		int max_x{ last_node(source.x + source.radius, columns) };
+		int max_y{ last_node(source.y + source.radius, rows) };
+
+		float radius2{ source.radius * source.radius };
+		// Bounds the 1 / distance^2 terms for nodes next to the source center.
+		float min_dist2{ 0.25f * cell_size * cell_size };
+
+		for (int j{ min_y }; j <= max_y; j++) {
+			float dy{ source.y - j * cell_size };
+			for (int i{ min_x }; i <= max_x; i++) {
+				float dx{ source.x - i * cell_size };
+				float dist2{ dx * dx + dy * dy };
+				if (dist2 > radius2) {
+					continue;
+				}
+				float inverse{ 1.0f / std::max(dist2, min_dist2) };
+				// Direction points from the node toward the source, skewed is (-y, x).
+				WindSample& node{ nodes[static_cast<std::size_t>(j) * columns + i] };
+				node.suction_x	+= dx * inverse * source.suction;
+				node.suction_y	+= dy * inverse * source.suction;
+				node.wind_x		+= -dy * inverse * source.wind;
+				node.wind_y		+= dx * inverse * source.wind;
+				node.velocity_x += source.velocity_x;
+				node.velocity_y += source.velocity_y;
+				node.coverage	+= 1.0f;
+			}
+		}
+	}
+
+	[[nodiscard]] WindSample Sample(float x, float y) const {
+		float fx{ std::clamp(x / cell_size, 0.0f, static_cast<float>(columns - 1)) };
+		float fy{ std::clamp(y / cell_size, 0.0f, static_cast<float>(rows - 1)) };
+		int x0{ std::min(static_cast<int>(fx), columns - 2) };
+		int y0{ std::min(static_cast<int>(fy), rows - 2) };
+		float tx{ fx - x0 };
+		float ty{ fy - y0 };
+
+		const WindSample* top{ &nodes[static_cast<std::size_t>(y0) * columns + x0] };
+		const WindSample* bottom{ top + columns };
+
+		float w00{ (1.0f - tx) * (1.0f - ty) };
+		float w10{ tx * (1.0f - ty) };
+		float w01{ (1.0f - tx) * ty };
+		float w11{ tx * ty };
+
+		auto lerp = [&](float WindSample::*member) {
+			return top[0].*member * w00 + top[1].*member * w10 + bottom[0].*member * w01 +
+				   bottom[1].*member * w11;
+		};
+
+		WindSample sample;
+		sample.suction_x  = lerp(&WindSample::suction_x);
+		sample.suction_y  = lerp(&WindSample::suction_y);
+		sample.wind_x	  = lerp(&WindSample::wind_x);
+		sample.wind_y	  = lerp(&WindSample::wind_y);
+		sample.velocity_x = lerp(&WindSample::velocity_x);
+		sample.velocity_y = lerp(&WindSample::velocity_y);
+		sample.coverage	  = lerp(&WindSample::coverage);
+		return sample;
+	}
+
+private:
+	float cell_size{ 0.0f };
+	int columns{ 0 };
+	int rows{ 0 };
+	std::vector<WindSample> nodes;
+};
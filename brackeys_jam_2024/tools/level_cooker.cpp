@@ -0,0 +1,248 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "level_database.h"
+#include "protegon/protegon.h"
+
+using namespace ptgn;
+
+// Cooks levels.json into the binary level database read by the game.
+// Usage: level_cooker <levels.json> <levels.bin>
+
+namespace {
+
+using namespace level_database;
+
+class Cooker {
+public:
+	explicit Cooker(const json& data) {
+		header.car_volume				= data.at("volume").at("car");
+		header.music_volume				= data.at("volume").at("music");
+		header.tornadoes_max_volume		= data.at("volume").at("tornadoes_max");
+		header.tornadoes_ambient_volume = data.at("volume").at("tornadoes_ambient");
+
+		const auto& json_levels = data.at("levels");
+		levels.resize(json_levels.size());
+
+		std::vector<bool> cooked(json_levels.size(), false);
+
+		for (const auto& l : json_levels) {
+			int id = l.at("id");
+			if (id < 0 || static_cast<std::size_t>(id) >= json_levels.size() || cooked[id]) {
+				throw std::runtime_error{ "Level ids must be unique and cover [0, level count): " +
+										  std::to_string(id) };
+			}
+			cooked[id]	  = true;
+			levels[id]	  = CookLevel(l);
+			levels[id].id = id;
+		}
+
+		for (const auto& d : data.at("difficulty_layers")) {
+			difficulty_layers.push_back({ AddString(d.at("music")) });
+		}
+
+		for (const auto& b : data.at("branches")) {
+			Range branch{ static_cast<std::uint32_t>(branch_levels.size()),
+						  static_cast<std::uint32_t>(b.size()) };
+			for (int l : b) {
+				CheckLevelId(l, json_levels.size(), "branch");
+				branch_levels.push_back(l);
+			}
+			branches.push_back(branch);
+		}
+
+		for (int l : data.at("completed_levels")) {
+			CheckLevelId(l, json_levels.size(), "completed_levels");
+			completed_levels.push_back(l);
+		}
+	}
+
+	[[nodiscard]] std::vector<char> Write() {
+		std::vector<char> file(sizeof(Header));
+		header.levels			  = Append(file, levels);
+		header.tornadoes		  = Append(file, tornadoes);
+		header.sequence_keyframes = Append(file, sequence_keyframes);
+		header.difficulty_layers  = Append(file, difficulty_layers);
+		header.branches			  = Append(file, branches);
+		header.branch_levels	  = Append(file, branch_levels);
+		header.completed_levels	  = Append(file, completed_levels);
+		header.strings			  = Append(file, strings);
+		std::memcpy(file.data(), &header, sizeof(Header));
+		return file;
+	}
+
+private:
+	static void CheckLevelId(int id, std::size_t level_count, const std::string& list) {
+		if (id < 0 || static_cast<std::size_t>(id) >= level_count) {
+			throw std::runtime_error{ "Level id " + std::to_string(id) + " in " + list +
+									  " does not exist" };
+		}
+	}
+
+	Level CookLevel(const json& l) {
+		Level level;
+		level.seed			= l.at("seed");
+		level.screen_width	= l.at("screen_size").at(0);
+		level.screen_height = l.at("screen_size").at(1);
+		if (l.contains("streaming")) {
+			level.streaming = l.at("streaming").get<bool>() ? 1 : 0;
+		}
+		if (l.contains("wind_field")) {
+			level.wind_field_cell_size = l.at("wind_field").at("cell_size");
+		}
+		level.win_text = AddString(l.at("win_text"));
+		level.ui_icon  = AddString(l.at("ui_icon"));
+		level.details  = AddString(l.at("details"));
+
+		const auto& json_tornadoes = l.at("tornadoes");
+		if (json_tornadoes.empty()) {
+			throw std::runtime_error{
+				"Each level must have at least one tornado specified in the JSON"
+			};
+		}
+		level.tornadoes = { static_cast<std::uint32_t>(tornadoes.size()),
+							static_cast<std::uint32_t>(json_tornadoes.size()) };
+		for (const auto& t : json_tornadoes) {
+			tornadoes.push_back(CookTornado(t));
+		}
+		return level;
+	}
+
+	Tornado CookTornado(const json& t) {
+		Tornado tornado;
+		tornado.texture			= AddString(t.at("texture"));
+		tornado.turn_speed		= t.at("turn_speed");
+		tornado.increment_speed = t.at("increment_speed");
+		tornado.escape_radius	= t.at("escape_radius");
+		tornado.warning_radius	= t.at("warning_radius");
+		tornado.data_radius		= t.at("data_radius");
+		tornado.gravity_radius	= t.at("gravity_radius");
+
+		if (t.contains("static")) {
+			const auto& pos	 = t.at("static").at("pos");
+			tornado.flags	|= TornadoFlags::Static;
+			tornado.x		 = pos.at(0);
+			tornado.y		 = pos.at(1);
+		} else if (t.contains("sequence")) {
+			const auto& sequence = t.at("sequence");
+			if (sequence.size() < 2) {
+				throw std::runtime_error{
+					"JSON tornado sequence must contain at least two entries"
+				};
+			}
+			tornado.flags	 |= TornadoFlags::Sequence;
+			tornado.x		  = sequence.at(0).at("pos").at(0);
+			tornado.y		  = sequence.at(0).at("pos").at(1);
+			tornado.sequence  = { static_cast<std::uint32_t>(sequence_keyframes.size()),
+								  static_cast<std::uint32_t>(sequence.size()) };
+			for (const auto& keyframe : sequence) {
+				SequenceKeyframe k;
+				k.x = keyframe.at("pos").at(0);
+				k.y = keyframe.at("pos").at(1);
+				// The last keyframe is only a destination.
+				if (keyframe.contains("time_to_next")) {
+					k.time_to_next_ms = keyframe.at("time_to_next");
+				}
+				sequence_keyframes.push_back(k);
+			}
+		}
+
+		if (tornado.flags == 0) {
+			throw std::runtime_error{ "Failed to create tornado position from given JSON data" };
+		}
+
+		if (t.contains("custom1")) {
+			const auto& custom		  = t.at("custom1");
+			tornado.flags			 |= TornadoFlags::Custom1;
+			tornado.rotation_x		  = custom.at("rotation_pos").at(0);
+			tornado.rotation_y		  = custom.at("rotation_pos").at(1);
+			tornado.end_x			  = custom.at("end_pos").at(0);
+			tornado.end_y			  = custom.at("end_pos").at(1);
+			tornado.rotation_time_ms  = custom.at("rotation_time");
+			tornado.linear_time_ms	  = custom.at("linear_time");
+		}
+
+		return tornado;
+	}
+
+	StringRef AddString(const std::string& string) {
+		StringRef ref{ static_cast<std::uint32_t>(strings.size()),
+					   static_cast<std::uint32_t>(string.size()) };
+		strings.insert(strings.end(), string.begin(), string.end());
+		strings.push_back('\0');
+		return ref;
+	}
+
+	template <typename T>
+	static Range Append(std::vector<char>& file, const std::vector<T>& array) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		// Keep every array 4 byte aligned.
+		file.resize((file.size() + 3) & ~std::size_t{ 3 });
+		Range range{ static_cast<std::uint32_t>(file.size()),
+					 static_cast<std::uint32_t>(array.size()) };
+		const char* bytes{ reinterpret_cast<const char*>(array.data()) };
+		file.insert(file.end(), bytes, bytes + array.size() * sizeof(T));
+		return range;
+	}
+
+	Header header;
+	std::vector<Level> levels;
+	std::vector<Tornado> tornadoes;
+	std::vector<SequenceKeyframe> sequence_keyframes;
+	std::vector<DifficultyLayer> difficulty_layers;
+	std::vector<Range> branches;
+	std::vector<std::int32_t> branch_levels;
+	std::vector<std::int32_t> completed_levels;
+	std::vector<char> strings;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::cerr << "Usage: level_cooker <levels.json> <levels.bin>\n";
+		return 1;
+	}
+
+	std::ifstream json_file{ argv[1] };
+	if (!json_file) {
+		std::cerr << "Failed to open " << argv[1] << "\n";
+		return 1;
+	}
+
+	// Malformed JSON and invalid level data fail the cook in every build type.
+	std::vector<char> file;
+	try {
+		Cooker cooker{ json::parse(json_file) };
+		file = cooker.Write();
+	} catch (const std::exception& e) {
+		std::cerr << "Failed to cook " << argv[1] << ": " << e.what() << "\n";
+		return 1;
+	}
+
+	// Written to a temporary file first so an interrupted cook never leaves a partial table.
+	std::string output{ argv[2] };
+	std::string temporary{ output + ".tmp" };
+	{
+		std::ofstream out{ temporary, std::ios::binary | std::ios::trunc };
+		out.write(file.data(), static_cast<std::streamsize>(file.size()));
+		if (!out) {
+			std::cerr << "Failed to write " << temporary << "\n";
+			return 1;
+		}
+	}
+	std::remove(output.c_str());
+	if (std::rename(temporary.c_str(), output.c_str()) != 0) {
+		std::cerr << "Failed to replace " << output << "\n";
+		return 1;
+	}
+
+	return 0;
+}